@@ -17,7 +17,8 @@ public:\
     using mod_type1 = typename std::remove_cvref_t<ME>::mod_type;\
     using mod_type2 = typename std::remove_cvref_t<MF>::mod_type;\
     using int_type = typename std::remove_cvref_t<ME>::int_type;\
-    using mod_int_type = modint<mod_type>;\
+    using reduction_type = typename std::remove_cvref_t<ME>::reduction_type;\
+    using mod_int_type = modint<mod_type, reduction_type>;\
 \
     const mod_type  mod;\
 \
@@ -27,16 +28,21 @@ public:\
         , exp2_(exp2)\
     {\
         static_assert(detail::is_compatible_v<mod_type1, mod_type2> != compatibility::incompatible);\
+        static_assert(std::is_same_v<reduction_type, typename std::remove_cvref_t<MF>::reduction_type>);\
     }\
 \
-    constexpr modint<mod_type> evaluate() const noexcept {\
+    constexpr mod_int_type evaluate() const noexcept {\
         mod_int_type result = exp1_.evaluate();\
         return result op##= exp2_.evaluate();\
     }\
-    template<class M>\
-    constexpr void evaluate(modint<M>& dest) const noexcept {\
-        exp1_.evaluate(dest);\
-        dest op##= exp2_;\
+    template<class M, class R>\
+    constexpr void evaluate(modint<M, R>& dest) const noexcept {\
+        if constexpr (std::is_same_v<R, reduction_type>) {\
+            exp1_.evaluate(dest);\
+            dest op##= exp2_;\
+        } else {\
+            evaluate().evaluate(dest);\
+        }\
     }\
 \
 private:\
@@ -19,34 +19,48 @@ concept derived_mod_expr = std::is_base_of_v<mod_expr_base, std::remove_cvref_t<
 
 } // namespace detail
 
-
-
-template<class Mod>
+/// @brief 演算の度に値を[0, m)に戻す(既定)
+struct strict_reduction {};
+/// @brief 値を[0, 2m)に保ち，get()，比較，他の方針への代入の時だけ[0, m)に戻す．
+/// 加減算の補正は2mとの比較1回だけになり，乗算はMontgomery簡約の最後の比較と引き算を省く．
+/// 法の上に，符号なしなら2ビット，符号付きなら3ビットの空きが要る．
+struct lazy_reduction {};
+
+template<class Mod, class Reduction = strict_reduction>
 class modint : public detail::mod_expr_base {
 public:
-    template<class M>
+    template<class M, class R>
     friend class modint;
     using mod_type = std::remove_cvref_t<Mod>;
+    using reduction_type = Reduction;
     static constexpr unsigned int bit_length = mod_type::bit_length;
     using int_type = typename mod_type::int_type;
+    static constexpr bool is_lazy = std::is_same_v<Reduction, lazy_reduction>;
+    static_assert(std::is_same_v<Reduction, strict_reduction> || is_lazy);
+    static_assert(!is_lazy || detail::lazy_reduction_supported_v<mod_type>, "lazy_reduction needs spare bits above the modulus");
     mod_type mod;
 
     constexpr modint() = default;
     constexpr explicit modint(const int_type& value, const Mod & m = Mod{}) noexcept
         : mod{m}
         , mrep_(m.montgomery_representation(value))
-    {}
+    {
+        assert_lazy_reducible();
+    }
     template<class ...Args>
     constexpr explicit modint(const int_type& value, std::in_place_t, Args&& ...args) noexcept
         : mod{std::forward<Args>(args)...}
         , mrep_(mod.montgomery_representation(value))
-    {}
+    {
+        assert_lazy_reducible();
+    }
     template<detail::derived_mod_expr E>
     constexpr modint(E&& expr) {
         *this = expr;
     }
 
     constexpr explicit operator int_type() const noexcept {
+        // 簡約は2m未満の値も[0, m)に戻す
         return mod.montgomery_reduction(mrep_);
     }
     constexpr int_type get() const noexcept {
@@ -54,10 +68,10 @@ public:
         return (int_type)*this;
     }
 
-    template<class M>
-    constexpr void evaluate(modint<M>& dest) const noexcept {
+    template<class M, class R>
+    constexpr void evaluate(modint<M, R>& dest) const noexcept {
         assert(mod && mod.compatible_with(dest.mod) == compatibility::compatible);
-        dest.mrep_ = mrep_;
+        dest.mrep_ = modint<M, R>::is_lazy ? mrep_ : canonical();
         dest.mod = mod;
     }
     constexpr const modint& evaluate() const noexcept { return *this; }
@@ -75,22 +89,31 @@ public:
     template<detail::derived_mod_expr E>
     constexpr modint& operator+=(E&& expr) & noexcept {
         assert(expr.mod && mod.compatible_with(expr.mod) == compatibility::compatible);
-        mrep_ += expr.evaluate().mrep_;
-        shorten();
+        static_assert(std::is_same_v<Reduction, typename std::remove_cvref_t<E>::reduction_type>, "operands must use the same reduction policy");
+        // 法が型の範囲の半分を超えると和は型に収まらないので，先に法との差と比べる．
+        // 差は(0, m]に収まり，符号付きでも符号なしでも巻き戻らない．
+        const int_type rhs = expr.evaluate().mrep_;
+        const int_type gap = bound() - rhs;
+        if(mrep_ >= gap) mrep_ -= gap;
+        else mrep_ += rhs;
         return *this;
     }
     template<detail::derived_mod_expr E>
     constexpr modint& operator-=(E&& expr) & noexcept {
         assert(expr.mod && mod.compatible_with(expr.mod) == compatibility::compatible);
-        mrep_ -= expr.evaluate().mrep_;
-        shorten();
+        static_assert(std::is_same_v<Reduction, typename std::remove_cvref_t<E>::reduction_type>, "operands must use the same reduction policy");
+        // 符号なしの型では差が負にならないので，引く前に大小を比べる
+        const int_type rhs = expr.evaluate().mrep_;
+        if(mrep_ >= rhs) mrep_ -= rhs;
+        else mrep_ += bound() - rhs;
         return *this;
     }
     template<detail::derived_mod_expr E>
     constexpr modint& operator*=(E&& expr) & noexcept {
         assert(expr.mod && mod.compatible_with(expr.mod) == compatibility::compatible);
-        mrep_ *= expr.evaluate().mrep_;
-        mrep_ = mod.montgomery_reduction(mrep_);
+        static_assert(std::is_same_v<Reduction, typename std::remove_cvref_t<E>::reduction_type>, "operands must use the same reduction policy");
+        if constexpr (is_lazy) mrep_ = mod.montgomery_multiply_lazy(mrep_, expr.evaluate().mrep_);
+        else mrep_ = mod.montgomery_multiply(mrep_, expr.evaluate().mrep_);
         return *this;
     }
     template<detail::derived_mod_expr E>
@@ -109,7 +132,7 @@ public:
     -> std::enable_if_t<detail::is_compatible_v<Mod, typename E::mod_type> != compatibility::incompatible, bool>
     {
         assert(mod && expr.mod && mod.compatible_with(expr.mod) == compatibility::compatible);
-        return mrep_ == expr.evaluate().mrep_;
+        return canonical() == expr.evaluate().canonical();
     }
     template<detail::derived_mod_expr E>
     constexpr auto operator!=(const E& expr) const noexcept
@@ -118,11 +141,23 @@ public:
         return !(*this == expr);
     }
 private:
-    constexpr void shorten() noexcept {
-        if(mrep_ > mod.get_modulo()) mrep_ -= mod.get_modulo();
-        else if (mrep_ < 0) mrep_ += mod.get_modulo();
-    }
     int_type mrep_;
+
+    /// @brief Montgomery表現が取る値の上限(strict_reductionならm，lazy_reductionなら2m)
+    constexpr int_type bound() const noexcept {
+        if constexpr (is_lazy) return mod.get_modulo() + mod.get_modulo();
+        else return mod.get_modulo();
+    }
+    /// @brief [0, m)に戻したMontgomery表現
+    constexpr int_type canonical() const noexcept {
+        if constexpr (is_lazy) {
+            if(mrep_ >= mod.get_modulo()) return mrep_ - mod.get_modulo();
+        }
+        return mrep_;
+    }
+    constexpr void assert_lazy_reducible() const noexcept {
+        if constexpr (is_lazy && !std::is_empty_v<mod_type>) assert(mod.lazy_reducible());
+    }
 };
 
 template<class Mod>
@@ -131,5 +166,5 @@ modint(const chao::mp_int<sign::mp_signed, std::remove_cvref_t<Mod>::bit_length>
 
 template<detail::derived_mod_expr E>
 modint(E&&)
-->modint<typename std::remove_cvref_t<E>::mod_type>;
+->modint<typename std::remove_cvref_t<E>::mod_type, typename std::remove_cvref_t<E>::reduction_type>;
 }
@@ -1,4 +1,9 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
 #include <tuple>
 #include <type_traits>
 
@@ -27,6 +32,114 @@ struct basic_modulus {
     }
 };
 
+/// @brief R = 2^(64*length)とするMontgomery表現の計算に使う値の組．
+/// 法は奇数で，int_typeの正の値であればよい．乗算はmontgomery<length>::mul(CIOS)で行う．
+/// @tparam E 値の型．整数型は1桁として扱う
+template<expression E>
+struct montgomery_context {
+    using int_type = E;
+    using limb_type = impl_base::int_type;
+    static constexpr unsigned int bit_length = bit_length_v<E>;
+    static constexpr unsigned int length = length_v<E>;
+    using limbs = std::array<limb_type, length>;
+    using kernel = montgomery<length>;
+
+    /// @brief 法
+    limbs m{};
+    /// @brief R^2 mod m
+    limbs r2{};
+    /// @brief -m^-1 mod 2^64
+    limb_type m_dash = 0;
+
+    constexpr montgomery_context() = default;
+    constexpr explicit montgomery_context(const int_type& mod) noexcept
+        : m(magnitude(mod))
+        , r2(r_squared(mod))
+        , m_dash(kernel::neg_inv(m[0]))
+    {}
+
+    /// @brief a * b * R^-1 mod m．a, bはmより小さい非負の値
+    constexpr int_type multiply(const int_type& a, const int_type& b) const noexcept {
+        limbs r = magnitude(a);
+        const limbs y = magnitude(b);
+        kernel::mul(r.data(), r.data(), y.data(), m.data(), m_dash);
+        return from_limbs(r);
+    }
+    /// @brief multiplyの最後の引き算を省く．a, b < 2mのとき結果は2m未満
+    constexpr int_type multiply_lazy(const int_type& a, const int_type& b) const noexcept {
+        limbs r = magnitude(a);
+        const limbs y = magnitude(b);
+        kernel::template mul<false>(r.data(), r.data(), y.data(), m.data(), m_dash);
+        return from_limbs(r);
+    }
+    /// @brief 値を[0, 2m)に保つ遅延簡約が使えるか．
+    /// 2つの値の和(4m未満)がint_typeの正の値に収まればよい．このとき4m <= Rも成り立つ．
+    constexpr bool lazy_reducible() const noexcept {
+        unsigned int bits = 0;
+        for(auto i = length; i-- > 0;) {
+            if(m[i]) {
+                bits = i * 64 + std::bit_width(m[i]);
+                break;
+            }
+        }
+        return bits + 2 + (sign_v<int_type> == sign::mp_signed) <= bit_length;
+    }
+    /// @brief t * R mod m．負の値は絶対値の表現から作る．
+    constexpr int_type representation(const int_type& t) const noexcept {
+        // |t| < Rなので，r2 < mとの積の簡約はmより小さくなる
+        limbs r = magnitude(t);
+        kernel::mul(r.data(), r.data(), r2.data(), m.data(), m_dash);
+        if(t < 0 && !std::all_of(r.begin(), r.end(), [](limb_type x) { return x == 0; })) {
+            limbs d = m;
+            impl_base::sub_n(d.data(), r.data(), length);
+            r = d;
+        }
+        return from_limbs(r);
+    }
+    /// @brief T * R^-1 mod m．Tは非負の値
+    constexpr int_type reduction(const int_type& t) const noexcept {
+        limbs r = magnitude(t);
+        limbs one{};
+        one[0] = 1;
+        kernel::mul(r.data(), r.data(), one.data(), m.data(), m_dash);
+        return from_limbs(r);
+    }
+
+    /// @brief |t|の桁
+    static constexpr limbs magnitude(const int_type& t) noexcept {
+        if constexpr (std::is_integral_v<int_type>) {
+            // 負の値は2の補数を符号なしで反転して絶対値にする
+            const auto u = (std::make_unsigned_t<int_type>)t;
+            return {(limb_type)(t < 0 ? (std::make_unsigned_t<int_type>)(0 - u) : u)};
+        } else {
+            mp_int<sign::mp_unsigned, bit_length> u = t;
+            if(t < 0) u = -u;
+            return u.value_.poly;
+        }
+    }
+    static constexpr int_type from_limbs(const limbs& l) noexcept {
+        if constexpr (std::is_integral_v<int_type>) {
+            return (int_type)l[0];
+        } else {
+            int_type r;
+            r.value_.poly = l;
+            r.normalize();
+            return r;
+        }
+    }
+    static constexpr limbs r_squared(const int_type& mod) noexcept {
+        typedef mp_int<sign::mp_unsigned, 128 * length + 64> wide;
+        wide r = 1;
+        r <<= 128 * length;
+        wide w = 0;
+        std::copy_n(magnitude(mod).begin(), length, w.value_.poly.begin());
+        r %= w;
+        limbs l{};
+        std::copy_n(r.value_.poly.begin(), length, l.begin());
+        return l;
+    }
+};
+
 } // namespace detail
 
 template<detail::expression E>
@@ -48,6 +161,9 @@ struct [[deprecated]] modulus {
     static constexpr int_type montgomery_reduction(const int_type& T) noexcept {
         return detail::basic_modulus<int_type>::montgomery_reduction(T, value, R_inv, M_dash); 
     }
+    static constexpr int_type montgomery_multiply(const int_type& a, const int_type& b) noexcept {
+        return montgomery_reduction(a * b);
+    }
     static constexpr int_type remainder(const int_type t) noexcept {
         return montgomery_reduction(montgomery_representation(t));
     }
@@ -85,21 +201,30 @@ struct mod {
     using int_type = std::enable_if_t<detail::expression<std::remove_cvref_t<decltype(M)>> ,std::remove_cvref_t<decltype(M)>>;
     static constexpr unsigned int bit_length = detail::bit_length_v<int_type>;
     static constexpr int_type value = M;
-    static constexpr int_type R = detail::basic_modulus<int_type>::R;
-    static constexpr int_type R_inv = mod_abs(std::get<1>(ex_gcd(R, M)), M);
-    static constexpr int_type R_2 = (R % M) * (R % M) % M;
-    static constexpr int_type M_dash = mod_abs<int_type>(R - std::get<1>(ex_gcd(M, R)), R);
-    static_assert(value < R);
+    static constexpr detail::montgomery_context<int_type> context{M};
+    /// @brief R^2 mod M．R = 2^(64*桁数)
+    static constexpr int_type R_2 = context.from_limbs(context.r2);
+    /// @brief -M^-1 mod 2^64
+    static constexpr std::uint64_t M_dash = context.m_dash;
+    static_assert(value > 0 && (context.m[0] & 1), "Montgomery representation requires an odd positive modulus");
 
     static constexpr int_type montgomery_representation(const int_type& t) noexcept {
-        return detail::basic_modulus<int_type>::montgomery_representation(t, value, R_inv, R_2, M_dash);
+        return context.representation(t);
     }
     static constexpr int_type montgomery_reduction(const int_type& T) noexcept {
-        return detail::basic_modulus<int_type>::montgomery_reduction(T, value, R_inv, M_dash); 
+        return context.reduction(T);
+    }
+    static constexpr int_type montgomery_multiply(const int_type& a, const int_type& b) noexcept {
+        return context.multiply(a, b);
+    }
+    static constexpr int_type montgomery_multiply_lazy(const int_type& a, const int_type& b) noexcept {
+        return context.multiply_lazy(a, b);
     }
     static constexpr int_type remainder(const int_type t) noexcept {
         return montgomery_reduction(montgomery_representation(t));
     }
+    /// @brief 値を[0, 2M)に保つlazy_reductionが使えるか
+    static constexpr bool lazy_reducible = context.lazy_reducible();
     
     constexpr mod() = default;
 
@@ -120,28 +245,33 @@ template<detail::expression E>
 struct dynamic_modulus {
     static constexpr unsigned int bit_length = detail::bit_length_v<std::remove_cvref_t<E>>;
     using int_type = E;
-    static constexpr int_type R = detail::basic_modulus<int_type>::R;
     dynamic_modulus() = default;
     dynamic_modulus(const int_type& m) noexcept {
         set_modulo(m);
     }
 
     int_type montgomery_representation(const int_type& t) const noexcept {
-        return detail::basic_modulus<int_type>::montgomery_representation(t, value_, R_inv_, R_2_, M_dash_);
+        return context_.representation(t);
     }
     int_type montgomery_reduction(const int_type& T) const noexcept {
-        return detail::basic_modulus<int_type>::montgomery_reduction(T, value_, R_inv_, M_dash_); 
+        return context_.reduction(T);
+    }
+    int_type montgomery_multiply(const int_type& a, const int_type& b) const noexcept {
+        return context_.multiply(a, b);
+    }
+    int_type montgomery_multiply_lazy(const int_type& a, const int_type& b) const noexcept {
+        return context_.multiply_lazy(a, b);
+    }
+    /// @brief 値を[0, 2m)に保つlazy_reductionが使えるか．法は実行時に決まるので実行時に調べる
+    bool lazy_reducible() const noexcept {
+        return context_.lazy_reducible();
     }
     int_type remainder(const int_type& t) const noexcept{
         return montgomery_reduction(montgomery_representation(t));
     }
     void set_modulo(const int_type& m) noexcept {
-        assert(m < R);
-        std::tie(std::ignore, R_inv_, M_dash_) = ex_gcd(R, m);
-
-        M_dash_ = mod_abs((int_type)(R - M_dash_), R);
-        R_inv_ = mod_abs(R_inv_, m);
-        R_2_ = ((R % m) * (R % m)) % m;
+        context_ = detail::montgomery_context<int_type>(m);
+        assert(m > 0 && (context_.m[0] & 1));
         value_ = m;
     }
     const int_type& get_modulo() const noexcept { return value_; }
@@ -161,9 +291,7 @@ struct dynamic_modulus {
     }
 private:
     int_type value_ = 0;
-    int_type R_inv_;
-    int_type R_2_;
-    int_type M_dash_;
+    detail::montgomery_context<int_type> context_;
 };
 
 namespace detail {
@@ -205,6 +333,15 @@ struct is_compatible<dynamic_modulus<M>, dynamic_modulus<N>> {
 template<class Mod1, class Mod2>
 inline constexpr compatibility is_compatible_v = is_compatible<Mod1, Mod2>::value;
 
+/// @brief lazy_reductionを使えることがコンパイル時に分かるか．
+/// dynamic_modulusは法が決まった時にassertで調べる．旧来のmodulusは対応しない．
+template<class Mod>
+inline constexpr bool lazy_reduction_supported_v = false;
+template<auto M>
+inline constexpr bool lazy_reduction_supported_v<mod<M>> = mod<M>::lazy_reducible;
+template<class E>
+inline constexpr bool lazy_reduction_supported_v<dynamic_modulus<E>> = true;
+
 } // namespace detail
 
 }
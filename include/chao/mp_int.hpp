@@ -4,6 +4,15 @@
 #include "mp_int/operators.hpp"
 #include "mp_int/literals.hpp"
 #include "mp_int/convertion.hpp"
+#include "mp_int/bytes.hpp"
+#include "mp_int/mp_int_file.hpp"
+#include "mp_int/mp_int_text_writer.hpp"
 #include "mp_int/io.hpp"
+#include "mp_int/format.hpp"
 #include "mp_int/math.hpp"
 #include "mp_int/adaptor.hpp"
+#include "mp_int/accumulator.hpp"
+#include "mp_int/mp_int_vector.hpp"
+#include "mp_int/mp_int_view.hpp"
+#include "mp_int/dynamic_mp_int.hpp"
+#include "mp_int/memory_resource.hpp"
@@ -0,0 +1,138 @@
+#pragma once
+#include <array>
+#include <limits>
+#include <type_traits>
+
+#include "mp_int.hpp"
+#include "expression.hpp"
+#include "operators.hpp"
+
+namespace chao {
+
+/// @brief 桁上がりを遅延させる加算器．多数の積や値の総和を2^BitWidthを法として求める．
+/// 各桁を下位桁lo_と桁上がりの個数hi_(重みは一つ上の桁)の組で保持し，
+/// 加算の度には桁上がりを伝播させず，値を読み出すときにだけ正規化する．
+/// 桁上がりの個数は桁ごとに64ビットで数え，2^64-1個溜まる前に自動で正規化する．
+/// @tparam BitWidth 結果のビット幅
+template<unsigned int BitWidth>
+class accumulator {
+public:
+    using int_type = detail::impl_base::int_type;
+    static constexpr unsigned int bit_length = BitWidth;
+    static constexpr unsigned int length = mp_int<sign::mp_unsigned, BitWidth>::length;
+    /// @brief 正規化せずに溜められる桁上がりの個数
+    static constexpr int_type capacity = std::numeric_limits<int_type>::max();
+
+    constexpr accumulator() noexcept
+        : lo_{}
+        , hi_{}
+        , pending_(0)
+    {}
+    template<detail::expression E>
+    constexpr explicit accumulator(const E& e) noexcept
+        : accumulator()
+    {
+        *this += e;
+    }
+
+    /// @brief 値を加える
+    template<detail::expression E>
+    constexpr accumulator& operator+=(const E& e) noexcept {
+        decltype(auto) v = detail::operand_of_width<BitWidth, false>(e);
+        reserve(1);
+        for(auto i = 0u; i < length; ++i) absorb(i, v.value_.poly[i]);
+        return *this;
+    }
+    /// @brief 積を桁上がりを伝播させずに加える
+    template<detail::expression L, detail::expression R>
+    constexpr accumulator& operator+=(const mul_expr<L, R>& e) noexcept {
+        return add_product(e.lhs(), e.rhs());
+    }
+    /// @brief 値を引く．~e + 1を加える．
+    template<detail::expression E>
+    constexpr accumulator& operator-=(const E& e) noexcept {
+        decltype(auto) v = detail::operand_of_width<BitWidth, false>(e);
+        reserve(2);
+        for(auto i = 0u; i < length; ++i) absorb(i, ~v.value_.poly[i]);
+        absorb(0, 1);
+        return *this;
+    }
+    /// @brief a * bの下位BitWidthビットを加える
+    template<detail::expression L, detail::expression R>
+    constexpr accumulator& add_product(const L& a, const R& b) noexcept {
+        decltype(auto) x = detail::operand_of_width<BitWidth, false>(a);
+        decltype(auto) y = detail::operand_of_width<BitWidth, false>(b);
+        reserve(2 * length);
+        for(auto i = 0u; i < length; ++i) {
+            if(!x.value_.poly[i]) continue;
+            for(auto j = 0u; i + j < length; ++j) {
+                int_type lo;
+                const int_type hi = detail::naive_mul::mul(lo, x.value_.poly[i], y.value_.poly[j]);
+                absorb(i + j, lo);
+                if(i + j + 1 < length) absorb(i + j + 1, hi);
+            }
+        }
+        return *this;
+    }
+    /// @brief 他の加算器(例えばスレッド毎の部分和)を合算する
+    constexpr accumulator& merge(const accumulator& other) noexcept {
+        if(other.pending_ > capacity - 1) {
+            accumulator tmp = other;
+            tmp.normalize();
+            return merge(tmp);
+        }
+        reserve(other.pending_ + 1);
+        for(auto i = 0u; i < length; ++i) {
+            absorb(i, other.lo_[i]);
+            hi_[i] += other.hi_[i];
+        }
+        return *this;
+    }
+
+    /// @brief 桁上がりを伝播させ，hi_を全て0にする
+    constexpr void normalize() noexcept {
+        if(!pending_) return;
+        detail::carry_accumulator acc{0, 0};
+        for(auto i = 0u; i < length; ++i) {
+            acc.add(lo_[i]);
+            lo_[i] = acc.shift();
+            acc.add(hi_[i]);
+            hi_[i] = 0;
+        }
+        pending_ = 0;
+    }
+    constexpr void clear() noexcept {
+        *this = accumulator();
+    }
+    template<sign Sign = sign::mp_signed>
+    constexpr mp_int<Sign, BitWidth> get() const noexcept {
+        accumulator tmp = *this;
+        tmp.normalize();
+        mp_int<Sign, BitWidth> r;
+        for(auto i = 0u; i < length; ++i) r.value_.poly[i] = tmp.lo_[i];
+        // 幅が64の倍数でなければ，最上位桁のBitWidthより上に溜まった桁上がりを切り捨てる
+        r.normalize();
+        return r;
+    }
+    template<sign Sign>
+    constexpr explicit operator mp_int<Sign, BitWidth>() const noexcept {
+        return get<Sign>();
+    }
+
+private:
+    std::array<int_type, length> lo_;
+    std::array<int_type, length> hi_;
+    /// @brief 正規化してから溜まった桁上がりの上限
+    int_type pending_;
+
+    /// @brief n個の桁上がりを受け入れられるようにする
+    constexpr void reserve(int_type n) noexcept {
+        if(pending_ > capacity - n) normalize();
+        pending_ += n;
+    }
+    constexpr void absorb(unsigned int i, int_type x) noexcept {
+        hi_[i] += detail::impl_base::addc(0, lo_[i], x, lo_[i]);
+    }
+};
+
+}
@@ -22,7 +22,7 @@ public:
     {
         constexpr auto org_rnd_bit_size = sizeof(std::invoke_result_t<Rnd>) * CHAR_BIT;
         mp_int<sign::mp_unsigned, BitWidth> res(0);
-        for(auto i = 0u; i < BitWidth / org_rnd_bit_size; ++i) {
+        for(auto i = 0u; i < (BitWidth + org_rnd_bit_size - 1) / org_rnd_bit_size; ++i) {
             res <<= org_rnd_bit_size;
             res |= rnd();
         }
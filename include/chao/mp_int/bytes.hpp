@@ -0,0 +1,186 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include "mp_int.hpp"
+#include "expression.hpp"
+#include "operators.hpp"
+
+namespace chao {
+
+/// @brief バイト列での語の並び順
+enum class word_order {
+    /// @brief 最上位の語から並べる(ビッグエンディアンのネットワークバイトオーダーなど)
+    most_significant_first,
+    /// @brief 最下位の語から並べる
+    least_significant_first
+};
+/// @brief 負の値の表し方
+enum class signed_encoding {
+    /// @brief 2の補数．書き出しでは出力の幅まで符号拡張し，読み込みでは最上位ビットを符号とする
+    twos_complement,
+    /// @brief 絶対値．符号は呼び出し側で別に扱う(mpz_export/mpz_importと同じ)
+    magnitude
+};
+
+namespace detail {
+
+constexpr std::uint64_t bswap64(std::uint64_t x) noexcept {
+#if defined(__cpp_lib_byteswap)
+    return std::byteswap(x);
+#elif defined(__GNUC__)
+    return __builtin_bswap64(x);
+#else
+    x = ((x & 0x00FF00FF00FF00FFull) << 8) | ((x >> 8) & 0x00FF00FF00FF00FFull);
+    x = ((x & 0x0000FFFF0000FFFFull) << 16) | ((x >> 16) & 0x0000FFFF0000FFFFull);
+    return (x << 32) | (x >> 32);
+#endif
+}
+
+/// @brief バイト列の語と語の中のバイトの並び
+struct byte_layout {
+    std::size_t size;
+    std::size_t word_size;
+    word_order order;
+    std::endian endian;
+
+    /// @brief 値の下位からp番目のバイトのバイト列での位置
+    constexpr std::size_t offset(std::size_t p) const noexcept {
+        const std::size_t j = p / word_size, k = p % word_size;
+        const std::size_t word = order == word_order::most_significant_first ? size / word_size - 1 - j : j;
+        return word * word_size + (endian == std::endian::big ? word_size - 1 - k : k);
+    }
+    /// @brief 値の下位のバイトから順に並ぶ
+    constexpr bool is_little() const noexcept {
+        return (order == word_order::least_significant_first || size == word_size)
+            && (endian == std::endian::little || word_size == 1);
+    }
+    /// @brief 値の上位のバイトから順に並ぶ
+    constexpr bool is_big() const noexcept {
+        return (order == word_order::most_significant_first || size == word_size)
+            && (endian == std::endian::big || word_size == 1);
+    }
+};
+
+inline byte_layout make_byte_layout(std::size_t size, std::size_t word_size, word_order order, std::endian endian) {
+    if(word_size == 0 || size % word_size) throw std::invalid_argument("byte count must be a multiple of the word size.");
+    return {size, word_size, order, endian};
+}
+
+/// @brief 桁a[0, len)(上はfillで延長)の下位size*8ビットをバイト列outに書く
+inline void write_limbs(unsigned char* out, const byte_layout& l, const impl_base::int_type* a, unsigned int len, unsigned char fill) noexcept {
+    const std::size_t full = std::min<std::size_t>(l.size / 8, len);
+    const std::size_t rem = l.size - full * 8;
+    if constexpr (std::endian::native == std::endian::little) {
+        if(l.is_little()) {
+            std::memcpy(out, a, full * 8);
+            if(full < len) std::memcpy(out + full * 8, a + full, rem);
+            else std::memset(out + full * 8, fill, rem);
+            return;
+        }
+        if(l.is_big()) {
+            // 桁ごとにバイトを反転して後ろから書く
+            for(std::size_t i = 0; i < full; ++i) {
+                const auto t = bswap64(a[i]);
+                std::memcpy(out + l.size - 8 * (i + 1), &t, 8);
+            }
+            if(full < len) {
+                const auto t = bswap64(a[full]);
+                std::memcpy(out, reinterpret_cast<const unsigned char*>(&t) + 8 - rem, rem);
+            } else {
+                std::memset(out, fill, rem);
+            }
+            return;
+        }
+    }
+    for(std::size_t p = 0; p < l.size; ++p) {
+        out[l.offset(p)] = p / 8 < len ? (unsigned char)(a[p / 8] >> (p % 8 * 8)) : fill;
+    }
+}
+/// @brief バイト列inの値の下位len*64ビットを桁a[0, len)に読む．入力より上の桁はfillで埋める．
+inline void read_limbs(impl_base::int_type* a, unsigned int len, const unsigned char* in, const byte_layout& l, bool negative) noexcept {
+    const std::size_t full = std::min<std::size_t>(l.size / 8, len);
+    const std::size_t rem = std::min<std::size_t>(l.size - full * 8, 8);
+    const impl_base::int_type fill = negative ? ~impl_base::int_type(0) : 0;
+    std::fill_n(a, len, fill);
+    if constexpr (std::endian::native == std::endian::little) {
+        if(l.is_little()) {
+            std::memcpy(a, in, full * 8);
+            if(full < len) std::memcpy(a + full, in + full * 8, rem);
+            return;
+        }
+        if(l.is_big()) {
+            for(std::size_t i = 0; i < full; ++i) {
+                impl_base::int_type t;
+                std::memcpy(&t, in + l.size - 8 * (i + 1), 8);
+                a[i] = bswap64(t);
+            }
+            if(full < len && rem) {
+                impl_base::int_type t = 0;
+                for(std::size_t i = 0; i < rem; ++i) t = t << 8 | in[i];
+                a[full] = fill << (8 * rem) | t;
+            }
+            return;
+        }
+    }
+    const std::size_t n = std::min<std::size_t>(l.size, (std::size_t)len * 8);
+    for(std::size_t p = 0; p < n; ++p) {
+        const unsigned int s = p % 8 * 8;
+        a[p / 8] = (a[p / 8] & ~((impl_base::int_type)0xFF << s)) | ((impl_base::int_type)in[l.offset(p)] << s);
+    }
+}
+
+}
+
+/// @brief eの下位size*8ビットをバイト列outに書く(mpz_exportに相当)．
+/// 出力の方が広ければ，2の補数では符号拡張し，絶対値では0で埋める．
+/// 既定ではビッグエンディアン(ネットワークバイトオーダー)で書く．
+/// @param out size バイトの出力先
+/// @param size 書き出すバイト数．word_sizeの倍数であること
+/// @param word_size 1語のバイト数
+/// @param order 語の並び順
+/// @param endian 語の中のバイト順
+template<detail::derived_expression E>
+void export_bytes(void* out, std::size_t size, const E& e,
+    std::size_t word_size = 1, word_order order = word_order::most_significant_first,
+    std::endian endian = std::endian::big, signed_encoding encoding = signed_encoding::twos_complement)
+{
+    using expr_t = std::remove_cvref_t<E>;
+    const auto l = detail::make_byte_layout(size, word_size, order, endian);
+    auto* o = static_cast<unsigned char*>(out);
+    decltype(auto) v = expr_to_mp_int(e);
+    const bool negative = v < 0;
+    if(negative && encoding == signed_encoding::magnitude) {
+        // 最小値の符号反転は符号付きでは表せないので，符号なしで絶対値をとる
+        mp_int<sign::mp_unsigned, detail::bit_length_v<expr_t>> m = v;
+        m = -m;
+        detail::write_limbs(o, l, m.value_.poly.data(), m.length, 0);
+        return;
+    }
+    // 最上位桁の余りのビットは符号拡張されているので，そのまま書いてよい
+    detail::write_limbs(o, l, v.value_.poly.data(), v.length, negative ? 0xFF : 0);
+}
+
+/// @brief バイト列inの値をvに読む(mpz_importに相当)．vより広い入力は2^BitWidthを法として切り詰める．
+/// 2の補数では，vが符号付きのとき入力の最上位ビットを符号として符号拡張する．
+/// @param in size バイトの入力
+/// @param size 読み込むバイト数．word_sizeの倍数であること
+template<sign Sign, unsigned int BitWidth>
+void import_bytes(mp_int<Sign, BitWidth>& v, const void* in, std::size_t size,
+    std::size_t word_size = 1, word_order order = word_order::most_significant_first,
+    std::endian endian = std::endian::big, signed_encoding encoding = signed_encoding::twos_complement)
+{
+    const auto l = detail::make_byte_layout(size, word_size, order, endian);
+    const auto* p = static_cast<const unsigned char*>(in);
+    const bool negative = Sign == sign::mp_signed && encoding == signed_encoding::twos_complement
+        && size && (p[l.offset(size - 1)] & 0x80);
+    detail::read_limbs(v.value_.poly.data(), v.length, p, l, negative);
+    v.normalize();
+}
+
+}
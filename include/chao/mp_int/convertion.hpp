@@ -1,7 +1,17 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <limits>
 #include <string_view>
 #include <string>
+#include <span>
+#include <system_error>
 #include <cstring>
+#include <vector>
 
 #include "mp_int.hpp"
 #include "expression.hpp"
@@ -33,6 +43,426 @@ constexpr int digit(char d, int base) noexcept {
     return result < base ? result : -1;
 }
 
+/// @brief 1桁に収まる最大の10の冪 10^19
+constexpr impl_base::int_type decimal_chunk = 10000000000000000000ull;
+constexpr unsigned int decimal_chunk_digits = 19;
+/// @brief この桁数以下の値は19桁ずつ畳み込む単純な方法で10進数字列から読む
+constexpr unsigned int decimal_dc_threshold = 24;
+/// @brief この桁数以下の値は10^19で割り続ける単純な方法で10進数にする
+constexpr unsigned int decimal_write_dc_threshold = 48;
+
+/// @brief 10^(19*2^k)の表．分割統治法による10進数字列の読み込みで使う．
+/// 全ての冪を一続きの領域に並べ，作業領域と共にallocから確保する．
+template<class Allocator = std::allocator<impl_base::int_type>>
+class decimal_power_table {
+public:
+    using int_type = impl_base::int_type;
+    using allocator_type = Allocator;
+    /// @param len 変換する値の桁数の上限．10^(19*2^k)がlen桁を超えるまで作る．
+    explicit decimal_power_table(unsigned int len, const Allocator& alloc = Allocator())
+        : limbs_(1, decimal_chunk, alloc)
+        , offsets_{0, 1}
+        , size_(1)
+    {
+        std::vector<int_type, Allocator> scratch(alloc);
+        while(offsets_[size_] - offsets_[size_ - 1] <= len) {
+            const auto off = offsets_[size_ - 1];
+            const auto n = (unsigned int)(offsets_[size_] - off);
+            limbs_.resize(offsets_[size_] + 2 * n);
+            scratch.resize(karatsuba::mul_n_scratch(n, n));
+            int_type* sq = limbs_.data() + offsets_[size_];
+            karatsuba::mul_n(sq, limbs_.data() + off, n, limbs_.data() + off, n, scratch.data());
+            offsets_[size_ + 1] = offsets_[size_] + impl_base::active_length(sq, 2 * n);
+            limbs_.resize(offsets_[++size_]);
+        }
+    }
+    [[nodiscard]]
+    std::span<const int_type> operator[](unsigned int k) const noexcept {
+        return {limbs_.data() + offsets_[k], offsets_[k + 1] - offsets_[k]};
+    }
+    [[nodiscard]]
+    unsigned int size() const noexcept { return size_; }
+private:
+    std::vector<int_type, Allocator> limbs_;
+    // 10^(19*2^k)は2^(k-1)桁以上あるので，32ビットで表せる桁数なら34個で尽きる
+    std::array<std::size_t, 40> offsets_;
+    unsigned int size_;
+};
+
+/// @brief 10^(19*2^k)とその逆数 floor(2^(128n) / 10^(19*2^k))(nは冪の桁数)の表．
+/// 分割統治法による10進数への変換で，Barrettの方法で冪による割り算を掛け算に置き換えるのに使う．
+class decimal_divisor_table {
+public:
+    using int_type = impl_base::int_type;
+    /// @brief 10^(19*2^k)がlen桁を超えるまで表を伸ばす．逆数は一度だけKnuth Dで求める．
+    void reserve(unsigned int len) {
+        while(powers_.empty() || powers_.back().size() <= len) {
+            std::vector<int_type> p;
+            if(powers_.empty()) {
+                p.assign(1, decimal_chunk);
+            } else {
+                const auto& d = powers_.back();
+                const auto n = (unsigned int)d.size();
+                p.resize(2 * n);
+                std::vector<int_type> scratch(karatsuba::mul_n_scratch(n, n));
+                karatsuba::mul_n(p.data(), d.data(), n, d.data(), n, scratch.data());
+                p.resize(impl_base::active_length(p.data(), 2 * n));
+            }
+            const auto n = (unsigned int)p.size();
+            std::vector<int_type> b(2 * n + 1, 0), m(n + 2), r(n), scratch(naive_mul::div_n_scratch(2 * n + 1, n));
+            b[2 * n] = 1;
+            naive_mul::div_n(m.data(), r.data(), b.data(), 2 * n + 1, p.data(), n, scratch.data());
+            m.resize(impl_base::active_length(m.data(), n + 2));
+            // 商と余り，割り算の作業領域の分だけ，この段で変換に使う作業領域が増える
+            workspace_ += 2 * n + 3 + division_workspace(n);
+            powers_.push_back(std::move(p));
+            reciprocals_.push_back(std::move(m));
+        }
+    }
+    [[nodiscard]]
+    const std::vector<int_type>& operator[](unsigned int k) const noexcept { return powers_[k]; }
+    [[nodiscard]]
+    unsigned int size() const noexcept { return (unsigned int)powers_.size(); }
+    /// @brief 表に収まる値を変換するのに足りる作業領域の桁数
+    [[nodiscard]]
+    std::size_t workspace_size() const noexcept { return workspace_; }
+    /// @brief a[0, len) < 10^(19*2^k)となる最小のk
+    [[nodiscard]]
+    unsigned int level_of(const int_type* a, unsigned int len) const noexcept {
+        len = impl_base::active_length(a, len);
+        unsigned int k = 0;
+        while(!less(a, len, powers_[k].data(), (unsigned int)powers_[k].size())) ++k;
+        return k;
+    }
+    /// @brief a[0, la) < (10^(19*2^k))^2 を10^(19*2^k)(n桁)で割る．q[0, n+2)に商を，r[0, n+1)に余りを書く．
+    /// 逆数を掛けて商を見積もり，高々2回の補正で正しい商にする．
+    void divide(int_type* q, int_type* r, const int_type* a, unsigned int la, unsigned int k, int_type* work) const noexcept {
+        const auto& d = powers_[k];
+        const auto& m = reciprocals_[k];
+        const auto n = (unsigned int)d.size(), lm = (unsigned int)m.size();
+        std::fill_n(q, n + 2, 0);
+        std::fill_n(r, n + 1, 0);
+        std::copy_n(a, std::min(la, n + 1), r);
+        if(la >= n) {
+            // q = floor(floor(a / 2^(64(n-1))) * m / 2^(64(n+1)))
+            const auto l1 = la - (n - 1);
+            int_type* const t = work;
+            int_type* const scratch = work + 2 * n + 3;
+            karatsuba::mul_n(t, a + (n - 1), l1, m.data(), lm, scratch);
+            const auto lq = impl_base::active_length(t + (n + 1), l1 + lm - (n + 1));
+            std::copy_n(t + (n + 1), lq, q);
+            if(lq) {
+                // r = a - q * d (mod 2^(64(n+1)))
+                karatsuba::mul_n(t, q, lq, d.data(), n, scratch);
+                impl_base::sub_n(r, t, n + 1);
+            }
+        }
+        while(!less(r, n + 1, d.data(), n)) {
+            impl_base::borrow_n(r + n, 1, impl_base::sub_n(r, d.data(), n));
+            impl_base::carry_n(q, n + 2, 1);
+        }
+    }
+private:
+    std::vector<std::vector<int_type>> powers_;
+    std::vector<std::vector<int_type>> reciprocals_;
+    std::size_t workspace_ = 0;
+
+    static constexpr std::size_t division_workspace(unsigned int n) noexcept {
+        return 2 * n + 3 + karatsuba::mul_n_scratch(n + 2, n + 2);
+    }
+    static bool less(const int_type* a, unsigned int la, const int_type* b, unsigned int lb) noexcept {
+        la = impl_base::active_length(a, la);
+        if(la != lb) return la < lb;
+        for(auto i = la; i-- > 0;) {
+            if(a[i] != b[i]) return a[i] < b[i];
+        }
+        return false;
+    }
+};
+
+/// @brief 数字に使う文字．std::to_charsと同じく小文字
+inline constexpr char digit_chars[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+/// @brief bitsビットの符号なしの値をbase進数で書くのに足りる文字数
+constexpr std::size_t max_chars(std::size_t bits, int base) noexcept {
+    if(std::has_single_bit((unsigned int)base)) {
+        const unsigned int b = std::countr_zero((unsigned int)base);
+        return std::max<std::size_t>(1, (bits + b - 1) / b);
+    }
+    // 30103/100000 > log10(2)，log_base(2) <= 1/floor(log2(base))
+    if(base == 10) return bits * 30103 / 100000 + 1;
+    return bits / (std::bit_width((unsigned int)base) - 1) + 1;
+}
+
+/// @brief a[0, len)をbase^m(1桁に収まる最大の冪)で割り続け，先頭の0を除いたbase進数として[first, last)に書く．aは壊れる．
+/// @return 書き込んだ末尾．収まらなければnullptr
+constexpr char* write_chunked(char* first, char* last, impl_base::int_type* a, unsigned int len, int base) noexcept {
+    using int_type = impl_base::int_type;
+    unsigned int m = 0;
+    int_type scale = 1;
+    while(scale <= std::numeric_limits<int_type>::max() / (int_type)base) {
+        scale *= base;
+        ++m;
+    }
+    // 後ろから書いて最後に先頭へ詰める
+    char* p = last;
+    len = impl_base::active_length(a, len);
+    do {
+        int_type rem = naive_mul::div_1(a, a, len, scale);
+        len = impl_base::active_length(a, len);
+        char d[64];
+        unsigned int c = 0;
+        do {
+            d[c++] = digit_chars[rem % base];
+            rem /= base;
+        } while(rem);
+        if(len) while(c < m) d[c++] = '0';
+        if(p - first < (std::ptrdiff_t)c) return nullptr;
+        for(auto i = 0u; i < c; ++i) *--p = d[i];
+    } while(len);
+    return std::copy(p, last, first);
+}
+/// @brief 2の冪の基数では桁から直接数字を取り出して[first, last)に書く
+/// @return 書き込んだ末尾．収まらなければnullptr
+constexpr char* write_pow2(char* first, char* last, const impl_base::int_type* a, unsigned int len, int base) noexcept {
+    len = impl_base::active_length(a, len);
+    if(!len) {
+        if(first == last) return nullptr;
+        *first = '0';
+        return first + 1;
+    }
+    const unsigned int bits = std::countr_zero((unsigned int)base);
+    const std::size_t width = (std::size_t)(len - 1) * 64 + std::bit_width(a[len - 1]);
+    const std::size_t n = (width + bits - 1) / bits;
+    if((std::size_t)(last - first) < n) return nullptr;
+    for(std::size_t i = 0; i < n; ++i) {
+        const std::size_t pos = i * bits, limb = pos / 64, off = pos % 64;
+        impl_base::int_type d = a[limb] >> off;
+        if(off + bits > 64 && limb + 1 < len) d |= a[limb + 1] << (64 - off);
+        first[n - 1 - i] = digit_chars[d & (base - 1)];
+    }
+    return first + n;
+}
+/// @brief vを0埋めした19桁の10進数としてout[0, 19)に書く
+constexpr void write_decimal_chunk(char* out, impl_base::int_type v) noexcept {
+    for(auto i = decimal_chunk_digits; i-- > 0;) {
+        out[i] = (char)('0' + v % 10);
+        v /= 10;
+    }
+}
+/// @brief a[0, len) < 10^(19*2^k)を0埋めした19*2^k桁の10進数としてoutに書く．
+/// 10^(19*2^(k-1))で割って上位と下位に分け，それぞれを再帰的に変換する．
+inline void write_decimal_dc(char* out, const impl_base::int_type* a, unsigned int len, unsigned int k, const decimal_divisor_table& powers, impl_base::int_type* work) noexcept {
+    using int_type = impl_base::int_type;
+    len = impl_base::active_length(a, len);
+    const std::size_t digits = (std::size_t)decimal_chunk_digits << k;
+    if(len <= decimal_write_dc_threshold) {
+        int_type t[decimal_write_dc_threshold];
+        std::copy_n(a, len, t);
+        char* p = out + digits;
+        do {
+            p -= decimal_chunk_digits;
+            write_decimal_chunk(p, naive_mul::div_1(t, t, len, decimal_chunk));
+            len = impl_base::active_length(t, len);
+        } while(len);
+        std::fill(out, p, '0');
+        return;
+    }
+    const std::size_t half = digits / 2;
+    const auto n = (unsigned int)powers[k - 1].size();
+    if(len < n) {
+        std::fill_n(out, half, '0');
+        write_decimal_dc(out + half, a, len, k - 1, powers, work);
+        return;
+    }
+    int_type* const q = work;
+    int_type* const r = work + n + 2;
+    powers.divide(q, r, a, len, k - 1, work + 2 * n + 3);
+    write_decimal_dc(out, q, n + 2, k - 1, powers, work + 2 * n + 3);
+    write_decimal_dc(out + half, r, n + 1, k - 1, powers, work + 2 * n + 3);
+}
+/// @brief a[0, len) < 10^(19*2^k)を先頭の0を除いた10進数として[first, last)に書く．
+/// 最上位の部分だけを詰めて書き，残りはwrite_decimal_dcで0埋めして書く．
+/// @return 書き込んだ末尾．収まらなければnullptr
+inline char* write_decimal_dc_trimmed(char* first, char* last, const impl_base::int_type* a, unsigned int len, unsigned int k, const decimal_divisor_table& powers, impl_base::int_type* work) noexcept {
+    using int_type = impl_base::int_type;
+    len = impl_base::active_length(a, len);
+    if(len <= decimal_write_dc_threshold) {
+        int_type t[decimal_write_dc_threshold];
+        std::copy_n(a, len, t);
+        return write_chunked(first, last, t, len, 10);
+    }
+    const auto n = (unsigned int)powers[k - 1].size();
+    if(len < n) return write_decimal_dc_trimmed(first, last, a, len, k - 1, powers, work);
+    int_type* const q = work;
+    int_type* const r = work + n + 2;
+    powers.divide(q, r, a, len, k - 1, work + 2 * n + 3);
+    char* p = write_decimal_dc_trimmed(first, last, q, n + 2, k - 1, powers, work + 2 * n + 3);
+    const std::size_t half = (std::size_t)decimal_chunk_digits << (k - 1);
+    if(!p || (std::size_t)(last - p) < half) return nullptr;
+    write_decimal_dc(p, r, n + 1, k - 1, powers, work + 2 * n + 3);
+    return p + half;
+}
+/// @brief 大きな値a[0, len)を分割統治法で10進数にして[first, last)に書く．
+/// 10の冪と逆数の表と作業領域はスレッドごとに持ち，それまでに変換した最も長い値に合わせて伸ばすので，
+/// 同じ幅の2回目以降の変換では確保しない．
+/// @return 書き込んだ末尾．収まらなければnullptr
+inline char* write_decimal_large(char* first, char* last, const impl_base::int_type* a, unsigned int len) {
+    thread_local decimal_divisor_table powers;
+    thread_local std::vector<impl_base::int_type> work;
+    powers.reserve(len);
+    if(work.size() < powers.workspace_size()) work.resize(powers.workspace_size());
+    return write_decimal_dc_trimmed(first, last, a, len, powers.level_of(a, len), powers, work.data());
+}
+/// @brief 符号なしの値a[0, len)をbase進数で[first, last)に書く．aは壊れる．
+/// 2の冪の基数は桁から直接取り出し，小さな値はbase^m(10進数なら10^19)で割り続けて切り出し，
+/// decimal_write_dc_threshold桁を超える10進数は分割統治法で変換する．
+/// 分割統治法の表と作業領域はwrite_decimal_largeが初めて必要になったときに確保する．
+/// @return 書き込んだ末尾．収まらなければnullptr
+constexpr char* write_unsigned(char* first, char* last, impl_base::int_type* a, unsigned int len, int base) {
+    if(std::has_single_bit((unsigned int)base)) return write_pow2(first, last, a, len, base);
+    len = impl_base::active_length(a, len);
+    if(base == 10 && len > decimal_write_dc_threshold && !std::is_constant_evaluated()) {
+        return write_decimal_large(first, last, a, len);
+    }
+    return write_chunked(first, last, a, len, base);
+}
+
+/// @brief p[0, 8)をリトルエンディアンの64ビット整数として読む
+constexpr impl_base::int_type load_8_chars(const char* p) noexcept {
+    impl_base::int_type x = 0;
+    for(auto i = 0u; i < 8; ++i) x |= (impl_base::int_type)(unsigned char)p[i] << (8 * i);
+    return x;
+}
+/// @brief load_8_chars で読んだ8文字が全て10進数字か(SWAR)
+constexpr bool is_8_decimal_digits(impl_base::int_type x) noexcept {
+    return ((x & 0xF0F0F0F0F0F0F0F0ull) | (((x + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+/// @brief load_8_chars で読んだ8文字の10進数字を値にする(SWAR)．隣り合う桁を2, 4, 8桁ずつまとめる．
+constexpr impl_base::int_type parse_8_decimal_digits(impl_base::int_type x) noexcept {
+    x -= 0x3030303030303030ull;
+    x = (x * 10 + (x >> 8)) & 0x00FF00FF00FF00FFull;
+    x = (x * 100 + (x >> 16)) & 0x0000FFFF0000FFFFull;
+    return (x * 10000 + (x >> 32)) & 0xFFFFFFFFull;
+}
+
+/// @brief 先頭から続くbase進数の数字の個数
+constexpr std::size_t count_digits(std::string_view str, int base) noexcept {
+    std::size_t i = 0;
+    if(base == 10) {
+        while(i + 8 <= str.size() && is_8_decimal_digits(load_8_chars(str.data() + i))) i += 8;
+    }
+    while(i < str.size() && digit(str[i], base) >= 0) ++i;
+    return i;
+}
+
+/// @brief 2の冪の基数の数字列を桁に直接並べる．r[0, len)は0で初期化されていること
+constexpr void parse_pow2_digits(impl_base::int_type* r, unsigned int len, const char* s, std::size_t n, int base) noexcept {
+    const unsigned int bits = std::countr_zero((unsigned int)base);
+    std::size_t pos = 0;
+    for(std::size_t i = n; i-- > 0 && pos < (std::size_t)len * 64; pos += bits) {
+        const auto d = (impl_base::int_type)digit(s[i], base);
+        const auto limb = pos / 64, off = pos % 64;
+        r[limb] |= d << off;
+        if(off + bits > 64 && limb + 1 < len) r[limb + 1] |= d >> (64 - off);
+    }
+}
+
+/// @brief 数字をできるだけ多く1桁の整数にまとめ，r = r * base^m + chunk で畳み込む．r[0, len)は0で初期化されていること
+constexpr void fold_digits(impl_base::int_type* r, unsigned int len, const char* s, std::size_t n, int base) noexcept {
+    using int_type = impl_base::int_type;
+    // base^mが1桁に収まる最大のm
+    unsigned int m = 0;
+    int_type scale = 1;
+    while(scale <= std::numeric_limits<int_type>::max() / (int_type)base) {
+        scale *= base;
+        ++m;
+    }
+    unsigned int used = 0;
+    for(std::size_t i = 0; i < n;) {
+        const unsigned int c = i == 0 && n % m ? (unsigned int)(n % m) : m;
+        int_type v = 0, mult = 1;
+        unsigned int j = 0;
+        if(base == 10) {
+            for(; j + 8 <= c; j += 8) {
+                v = v * 100000000 + parse_8_decimal_digits(load_8_chars(s + i + j));
+                mult *= 100000000;
+            }
+        }
+        for(; j < c; ++j) {
+            v = v * base + digit(s[i + j], base);
+            mult *= base;
+        }
+        i += c;
+        const int_type carry = naive_mul::mul_1(r, used, mult);
+        if(used < len) r[used] = carry;
+        impl_base::plus(r, (int)len, v);
+        used = impl_base::active_length(r, std::min(used + 2, len));
+    }
+}
+
+/// @brief 長い10進数字列の分割統治法による変換．下位の19*2^k桁と上位に分け，上位 * 10^(19*2^k) + 下位 を求める．
+/// r[0, len)は0で初期化されていること．作業領域はallocから確保する．
+template<class PowerAllocator, class Allocator>
+void parse_decimal_dc(impl_base::int_type* r, unsigned int len, const char* s, std::size_t n, const decimal_power_table<PowerAllocator>& powers, const Allocator& alloc) {
+    using int_type = impl_base::int_type;
+    if(n <= (std::size_t)decimal_chunk_digits * decimal_dc_threshold) {
+        fold_digits(r, len, s, n, 10);
+        return;
+    }
+    const std::size_t chunks = (n + decimal_chunk_digits - 1) / decimal_chunk_digits;
+    const unsigned int k = std::bit_width(chunks - 1) - 1;
+    const std::size_t lo_digits = (std::size_t)decimal_chunk_digits << k;
+    const auto p = powers[k];
+    const auto lp = (unsigned int)p.size();
+    parse_decimal_dc(r, std::min(len, lp), s + (n - lo_digits), lo_digits, powers, alloc);
+    std::vector<int_type, Allocator> hi(std::min(len, lp), 0, alloc);
+    parse_decimal_dc(hi.data(), (unsigned int)hi.size(), s, n - lo_digits, powers, alloc);
+    const auto lh = impl_base::active_length(hi.data(), (unsigned int)hi.size());
+    if(!lh) return;
+    std::vector<int_type, Allocator> t(lh + lp + karatsuba::mul_n_scratch(lh, lp), alloc);
+    karatsuba::mul_n(t.data(), hi.data(), lh, p.data(), lp, t.data() + lh + lp);
+    const auto lt = std::min(len, lh + lp);
+    impl_base::carry_n(r + lt, len - lt, impl_base::add_n(r, t.data(), lt));
+}
+/// @brief MaxDigits桁以下の10進数字列の読み込みに足りる10の冪の表．
+/// 固定幅の型の読み込みのためにMaxDigitsごとに一度だけ作り，以後は全てのスレッドから読むだけにする．
+template<std::size_t MaxDigits>
+const decimal_power_table<>& cached_decimal_powers() {
+    static const decimal_power_table<> powers((unsigned int)(MaxDigits / decimal_chunk_digits + 1));
+    return powers;
+}
+/// @brief 10^(64*len)は2^(64*len)の倍数なので，下位64*len桁より上の数字は結果に影響しない．
+/// 読む桁数を先に切り詰め，MaxDigitsが0なら10の冪の表を桁数に合わせてallocで作り，
+/// そうでなければcached_decimal_powers<MaxDigits>を使う．
+template<std::size_t MaxDigits, class Allocator>
+void parse_decimal_large(impl_base::int_type* r, unsigned int len, const char* s, std::size_t n, const Allocator& alloc) {
+    const std::size_t digits = std::min<std::size_t>(n, (std::size_t)len * 64);
+    s += n - digits;
+    n = digits;
+    if constexpr (MaxDigits != 0) {
+        assert(n <= MaxDigits);
+        parse_decimal_dc(r, len, s, n, cached_decimal_powers<MaxDigits>(), alloc);
+    } else {
+        const decimal_power_table<Allocator> powers((unsigned int)(n / decimal_chunk_digits + 1), alloc);
+        parse_decimal_dc(r, len, s, n, powers, alloc);
+    }
+}
+
+/// @brief base進数の数字列s[0, n)の値をr[0, len)に書く(2^(64*len)を法とする)．r[0, len)は0で初期化されていること．
+/// 長い10進数字列の作業領域はallocから確保する．
+/// @tparam MaxDigits 0でなければ，下位64*len桁に切り詰めた後の桁数の上限．10の冪の表を作るのがこの値ごとに一度だけになる．
+template<std::size_t MaxDigits = 0, class Allocator = std::allocator<impl_base::int_type>>
+constexpr void parse_digits(impl_base::int_type* r, unsigned int len, const char* s, std::size_t n, int base, const Allocator& alloc = Allocator()) {
+    if(std::has_single_bit((unsigned int)base)) {
+        parse_pow2_digits(r, len, s, n, base);
+    } else if(base == 10 && !std::is_constant_evaluated() && n > (std::size_t)decimal_chunk_digits * decimal_dc_threshold) {
+        parse_decimal_large<MaxDigits>(r, len, s, n, alloc);
+    } else {
+        fold_digits(r, len, s, n, base);
+    }
+}
+
 }
 
 template<unsigned int BitWidth = 128>
@@ -44,16 +474,13 @@ constexpr mp_int<sign::mp_unsigned, BitWidth> stoul(std::string_view str, size_t
         base = detail::detect_base(str);
         str = str.substr(base == 16 || base == 2 ? 2 : 0);
     }
-    for(unsigned int i = 0; i < str.size(); ++i) {
-        if(auto d = detail::digit(str[i], base); d >= 0) {
-            result *= base;
-            result += d;
-        } else {
-            idx && (*idx = i);
-            if(i == 0) throw std::invalid_argument("can't convert into mp_int from string.");
-            break;
-        }
+    const std::size_t n = detail::count_digits(str, base);
+    if(n < str.size()) {
+        idx && (*idx = n);
+        if(n == 0) throw std::invalid_argument("can't convert into mp_int from string.");
     }
+    detail::parse_digits<(std::size_t)mp_int<sign::mp_unsigned, BitWidth>::length * 64>(result.value_.poly.data(), result.length, str.data(), n, base);
+    result.normalize();
     return result;
 }
 
@@ -68,22 +495,72 @@ constexpr mp_int<sign::mp_signed, BitWidth> stoi(std::string_view str, size_t* c
     return is_negative ? -result : result;
 }
 
+/// @brief eをbase進数で[first, last)に書く．std::to_charsと同じく負の値には'-'を付け，数字は小文字を使う．
+/// 収まらなければ{last, std::errc::value_too_large}を返す．
+/// 動的確保をするのは，decimal_write_dc_threshold桁を超える10進数の変換で，
+/// スレッドごとの10の冪の表と作業領域をその幅に初めて合わせるときだけ．
 template<detail::derived_expression E>
-std::string to_string(E&& n) {
+std::to_chars_result to_chars(char* first, char* last, const E& e, int base = 10) {
     using expr_t = std::remove_cvref_t<E>;
-    constexpr unsigned int dec_digit_length = detail::bit_length_v<expr_t> / 3;
-    auto cp = n < 0 ? -n : n;
-    char buffer[dec_digit_length];
-    int i = dec_digit_length - 1;
+    constexpr unsigned int length = detail::length_v<expr_t>;
+    // 最小値の符号反転は符号付きでは表せないので，符号なしで絶対値をとる
+    decltype(auto) v = expr_to_mp_int(e);
+    mp_int<sign::mp_unsigned, detail::bit_length_v<expr_t>> cp = v;
+    if(v < 0) {
+        if(first == last) return {last, std::errc::value_too_large};
+        *first++ = '-';
+        cp = -cp;
+    }
+    char* const p = detail::write_unsigned(first, last, cp.value_.poly.data(), length, base);
+    if(!p) return {last, std::errc::value_too_large};
+    return {p, std::errc{}};
+}
 
-    buffer[i--] = 0;
-    do {
-        buffer[i--] = '0' + (int)expr_to_mp_int(cp % 10);
-        cp /= 10;
-    } while(cp);
-    if(n < 0) buffer[i] = '-';
-    else ++i;
-    return std::string(buffer + i);
+/// @brief [first, last)の先頭のbase進数をvalueに読む．std::from_charsと同じく，
+/// 接頭辞や空白は読まず，'-'は符号付きの型でだけ受け付ける．
+/// 数字が無ければ{first, std::errc::invalid_argument}，値が型に収まらなければ
+/// {数字の末尾, std::errc::result_out_of_range}を返し，どちらの場合もvalueは変えない．
+template<sign Sign, unsigned int BitWidth>
+constexpr std::from_chars_result from_chars(const char* first, const char* last, mp_int<Sign, BitWidth>& value, int base = 10) {
+    using int_type = detail::impl_base::int_type;
+    constexpr unsigned int length = mp_int<Sign, BitWidth>::length;
+    const char* p = first;
+    bool negative = false;
+    if constexpr (Sign == sign::mp_signed) {
+        if(p != last && *p == '-') {
+            negative = true;
+            ++p;
+        }
+    }
+    const std::size_t n = detail::count_digits(std::string_view(p, (std::size_t)(last - p)), base);
+    if(n == 0) return {first, std::errc::invalid_argument};
+    const char* const end = p + n;
+    while(end - p > 1 && *p == '0') ++p;
+    // 先頭がbase^(m-1)以上なので，m桁が2^BitWidthを超えるのはすぐに分かる．
+    // そうでなければ値は2^(2*BitWidth)未満なので，2倍の幅で読んでから範囲を確かめる．
+    const auto m = (std::size_t)(end - p);
+    if((m - 1) * (std::bit_width((unsigned int)base) - 1) >= BitWidth) return {end, std::errc::result_out_of_range};
+    std::array<int_type, 2 * length + 1> t{};
+    // 上の判定を通った10進数はBitWidth / 3 + 1桁以下
+    detail::parse_digits<BitWidth / 3 + 1>(t.data(), (unsigned int)t.size(), p, m, base);
+    const auto lt = detail::impl_base::active_length(t.data(), (unsigned int)t.size());
+    const std::size_t width = lt ? (std::size_t)(lt - 1) * 64 + std::bit_width(t[lt - 1]) : 0;
+    const std::size_t limit = Sign == sign::mp_signed ? BitWidth - 1 : BitWidth;
+    // 符号付きの最小値の絶対値2^(BitWidth-1)
+    const bool is_min = negative && width == BitWidth && std::has_single_bit(t[lt - 1])
+        && std::all_of(t.begin(), t.begin() + (lt - 1), [](int_type x) { return x == 0; });
+    if(width > limit && !is_min) return {end, std::errc::result_out_of_range};
+    std::copy_n(t.begin(), length, value.value_.poly.begin());
+    if(negative) value = -value;
+    value.normalize();
+    return {end, std::errc{}};
+}
+
+template<detail::derived_expression E>
+std::string to_string(E&& n) {
+    std::string s(detail::max_chars(detail::bit_length_v<std::remove_cvref_t<E>>, 10) + 1, '\0');
+    s.resize(to_chars(s.data(), s.data() + s.size(), n).ptr - s.data());
+    return s;
 }
 
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <bit>
 #include <climits>
@@ -14,6 +15,24 @@
 
 #define ERR_PLACE (std::string(" in ") + __func__ + " at " + __FILE__ + ":" + std::to_string(__LINE__))
 
+// carry chain intrinsics (adc/sbb)
+#if defined(_MSC_VER) && defined(_M_X64)
+#   include <intrin.h>
+#   define CHAO_HAS_ADDCARRY_U64 1
+#elif defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#   include <x86intrin.h>
+#   define CHAO_HAS_ADDCARRY_U64 1
+#endif
+#if defined(__has_builtin)
+#   if __has_builtin(__builtin_addcll) && __has_builtin(__builtin_subcll)
+#       define CHAO_HAS_BUILTIN_ADDC 1
+#   endif
+#endif
+// native 128 bit integer
+#if defined(__SIZEOF_INT128__)
+#   define CHAO_HAS_INT128 1
+#endif
+
 namespace chao{
 enum class sign {
     mp_unsigned, mp_signed
@@ -34,6 +53,17 @@ concept expression = std::is_base_of_v<detail::expression_base, std::remove_cvre
 template<class T>
 concept derived_expression = std::is_base_of_v<detail::expression_base, std::remove_cvref_t<T>>;
 
+/// @brief 式の評価結果を書き込める型(mp_intとmp_int_view)．
+/// 式はdata()の指すlength個の桁に直接書き，最後にnormalizeを呼ぶ．
+template<class D>
+concept limb_destination = !std::is_const_v<D> && requires(D& d) {
+    { d.data() } -> std::same_as<std::uint64_t*>;
+    d.normalize();
+    D::sign_value;
+    D::bit_length;
+    D::length;
+};
+
 
 template<class T, class U = void>
 constexpr unsigned int bit_length_v = 0;
@@ -79,13 +109,58 @@ constexpr sign sign_v<
     T, std::enable_if_t<std::is_base_of_v<expression_base, std::remove_cvref_t<T>>>
 > = std::remove_cvref_t<T>::sign_value;
 
-template<unsigned int Bits, std::enable_if_t<(Bits > 0 && Bits % 64 == 0 /* && std::has_single_bit(Bits)*/), int> = 0>
+/// @brief Bitsビットの値を表す桁の列pの最上位ビット
+template<unsigned int Bits>
+[[nodiscard]]
+constexpr bool msb_of_limbs(const std::uint64_t* p) noexcept {
+    return (p[(Bits - 1) / 64] >> ((Bits - 1) % 64)) & 1;
+}
+/// @brief Bitsビットの値を表す桁の列pの，最上位桁の余りのビットをビットBits-1に合わせて
+/// 符号拡張(Sign == mp_signed)または0埋めする．Bitsが64の倍数なら何もしない．
+template<sign Sign, unsigned int Bits>
+constexpr void normalize_limbs(std::uint64_t* p) noexcept {
+    constexpr unsigned int length = (Bits + 63) / 64, spare_bits = length * 64 - Bits;
+    if constexpr (spare_bits != 0) {
+        auto& top = p[length - 1];
+        if constexpr (Sign == sign::mp_signed) {
+            top = (std::uint64_t)((std::int64_t)(top << spare_bits) >> spare_bits);
+        } else {
+            top &= ~(std::uint64_t)0 >> spare_bits;
+        }
+    }
+}
+/// @brief SrcBitsビットの値srcをdest[0, len)に写す．Sign == mp_signedなら符号拡張し，そうでなければ0で埋める．
+/// destとsrcは同じ位置から始まっていてもよい．
+template<sign Sign, unsigned int SrcBits>
+constexpr void copy_limbs(std::uint64_t* dest, unsigned int len, const std::uint64_t* src) noexcept {
+    constexpr unsigned int src_length = (SrcBits + 63) / 64, src_spare_bits = src_length * 64 - SrcBits;
+    const std::uint64_t fill = (Sign == sign::mp_signed && msb_of_limbs<SrcBits>(src)) ? ~0ull : 0;
+    unsigned int i;
+    for(i = 0u; i < std::min(len, src_length); ++i) {
+        dest[i] = src[i];
+    }
+    for(; i < len; ++i) {
+        dest[i] = fill;
+    }
+    if constexpr (src_spare_bits != 0) {
+        // srcの余りのビットは符号拡張されているとは限らない
+        if(src_length <= len) dest[src_length - 1] |= fill << (64 - src_spare_bits);
+    }
+}
+
+/// @brief Bitsビットの整数を64ビットの桁の列で表す．
+/// Bitsが64の倍数でないとき，最上位桁のBitsを超える部分(spare_bits)は
+/// normalize<Sign>によって符号拡張(符号付き)または0埋め(符号なし)された状態に保つ．
+/// 演算の途中ではこの部分を桁上がりの受け皿として使ってよい．
+template<unsigned int Bits, std::enable_if_t<(Bits > 0), int> = 0>
 class int_representation {
 public:
     using coeff_type =  std::uint64_t;
     static constexpr unsigned int bit_length = Bits;
-    static constexpr unsigned int byte_length = Bits / CHAR_BIT;
-    static constexpr unsigned int coeff_length = byte_length / sizeof(coeff_type);
+    static constexpr unsigned int byte_length = (Bits + CHAR_BIT - 1) / CHAR_BIT;
+    static constexpr unsigned int coeff_length = (Bits + sizeof(coeff_type) * CHAR_BIT - 1) / (sizeof(coeff_type) * CHAR_BIT);
+    /// @brief 最上位桁のうちBitsより上にある余りのビット数
+    static constexpr unsigned int spare_bits = coeff_length * sizeof(coeff_type) * CHAR_BIT - Bits;
     static constexpr unsigned int poly_length = coeff_length;
     static constexpr unsigned int poly_byte_length = poly_length * sizeof(coeff_type);
     static constexpr unsigned int length = coeff_length;
@@ -121,21 +196,7 @@ public:
 
     template<sign Sign, unsigned int Other>
     constexpr int_representation& cpy(const int_representation<Other>& src) & noexcept {
-        const coeff_type fill = (Sign == sign::mp_signed && src.msb()) ? ~0ull : 0;
-        unsigned int i;
-        for(i = 0u; i < std::min(length, src.length); ++i) {
-            poly[i] = src.poly[i];
-        }
-        for(; i < length; ++i) {
-            poly[i] = fill;
-        }
-
-        // if (Sign == sign::mp_signed && src.msb()) {
-        //     std::memset(poly.data(), ~0, poly_byte_length);
-        // } else {
-        //     std::memset(poly.data(), 0, poly_byte_length);
-        // }
-        // std::memcpy(poly.data(), src.poly.data(), std::min(src.poly_byte_length, poly_byte_length));
+        copy_limbs<Sign, Other>(poly.data(), length, src.poly.data());
         return *this;
     }
 
@@ -200,7 +261,13 @@ public:
     /// @return if most significant bit is 1 then true, 0 then false
     [[nodiscard]]
     constexpr bool msb() const noexcept {
-        return !!(poly[length - 1] >> (sizeof(coeff_type) * CHAR_BIT - 1));
+        return !!((poly[length - 1] >> ((Bits - 1) % (sizeof(coeff_type) * CHAR_BIT))) & 1);
+    }
+    /// @brief 最上位桁の余りのビットをビットBits-1に合わせて符号拡張(Sign == mp_signed)または0埋めする．
+    /// Bitsが64の倍数なら何もしない．
+    template<sign Sign>
+    constexpr void normalize() noexcept {
+        normalize_limbs<Sign, Bits>(poly.data());
     }
     [[nodiscard]]
     constexpr operator bool() const noexcept {
@@ -226,4 +293,18 @@ constexpr int countl_zero(int_representation<Bits> const & a) noexcept {
     }
     return c;
 }
+
+#if defined(CHAO_HAS_INT128)
+__extension__ typedef unsigned __int128 native_uint128;
+__extension__ typedef __int128 native_int128;
+
+[[nodiscard]]
+constexpr native_uint128 to_native(const int_representation<128>& a) noexcept {
+    return (native_uint128)a.poly[1] << 64 | a.poly[0];
+}
+constexpr void from_native(int_representation<128>& a, native_uint128 v) noexcept {
+    a.poly[0] = (std::uint64_t)v;
+    a.poly[1] = (std::uint64_t)(v >> 64);
+}
+#endif
 }
@@ -10,6 +10,7 @@
 #include <iterator>
 #include <limits>
 #include <type_traits>
+#include <utility>
 
 #include "common.hpp"
 
@@ -18,6 +19,137 @@ namespace chao::detail{
 class impl_base {
 public:
     typedef typename int_representation<64>::coeff_type int_type;
+
+    /// @brief 桁上がり付き加算．out = a + b + c
+    /// @param c 下位からの繰り上がり(0 or 1)
+    /// @return 繰り上がり
+    static constexpr unsigned char addc(unsigned char c, int_type a, int_type b, int_type& out) noexcept
+    {
+        if(!std::is_constant_evaluated()) {
+#if defined(CHAO_HAS_ADDCARRY_U64)
+            unsigned long long r;
+            c = _addcarry_u64(c, a, b, &r);
+            out = r;
+            return c;
+#elif defined(CHAO_HAS_BUILTIN_ADDC)
+            unsigned long long co;
+            out = __builtin_addcll(a, b, c, &co);
+            return (unsigned char)co;
+#endif
+        }
+        const int_type s = a + b;
+        const unsigned char c1 = s < a;
+        out = s + c;
+        return c1 | (out < s);
+    }
+    /// @brief 借り付き減算．out = a - b - c
+    /// @param c 下位への借り(0 or 1)
+    /// @return 借り
+    static constexpr unsigned char subb(unsigned char c, int_type a, int_type b, int_type& out) noexcept
+    {
+        if(!std::is_constant_evaluated()) {
+#if defined(CHAO_HAS_ADDCARRY_U64)
+            unsigned long long r;
+            c = _subborrow_u64(c, a, b, &r);
+            out = r;
+            return c;
+#elif defined(CHAO_HAS_BUILTIN_ADDC)
+            unsigned long long co;
+            out = __builtin_subcll(a, b, c, &co);
+            return (unsigned char)co;
+#endif
+        }
+        const int_type d = a - b;
+        const unsigned char c1 = a < b;
+        out = d - c;
+        return c1 | (d < (int_type)c);
+    }
+    /// @brief 上位の0の桁を除いた桁数．値の実際の大きさで計算方法を選ぶのに使う．
+    static constexpr unsigned int active_length(const int_type* p, unsigned int len) noexcept
+    {
+        while(len && !p[len - 1]) --len;
+        return len;
+    }
+    template<unsigned int Bits>
+    static constexpr unsigned int active_length(const int_representation<Bits>& a) noexcept
+    {
+        return active_length(a.poly.data(), a.coeff_length);
+    }
+
+    /// @brief dest[0, len) += b + c．桁上がりの有無によらず全ての桁を加算する．
+    /// @return 繰り上がり
+    static constexpr unsigned char add_n(int_type* dest, const int_type* b, unsigned int len, unsigned char c = 0) noexcept
+    {
+        for(auto i = 0u; i < len; ++i) {
+            c = addc(c, dest[i], b[i], dest[i]);
+        }
+        return c;
+    }
+    /// @brief dest[0, len) -= b + c
+    /// @return 借り
+    static constexpr unsigned char sub_n(int_type* dest, const int_type* b, unsigned int len, unsigned char c = 0) noexcept
+    {
+        for(auto i = 0u; i < len; ++i) {
+            c = subb(c, dest[i], b[i], dest[i]);
+        }
+        return c;
+    }
+    /// @brief 繰り上がりをdest[0, len)に伝播させる
+    /// @return 最上位からの繰り上がり
+    static constexpr unsigned char carry_n(int_type* dest, unsigned int len, unsigned char c) noexcept
+    {
+        for(auto i = 0u; c && i < len; ++i) {
+            c = !++dest[i];
+        }
+        return c;
+    }
+    /// @brief 借りをdest[0, len)に伝播させる
+    /// @return 最上位からの借り
+    static constexpr unsigned char borrow_n(int_type* dest, unsigned int len, unsigned char c) noexcept
+    {
+        for(auto i = 0u; c && i < len; ++i) {
+            c = !dest[i]--;
+        }
+        return c;
+    }
+
+    /// @brief この長さ以下の演算はindex_sequenceで展開された固定長カーネルを使う
+    static constexpr unsigned int unroll_limit = 8;
+
+    /// @brief dest[0, N) += b[0, N) + c．ループを展開した分岐のない版．
+    /// @return 繰り上がり
+    template<std::size_t N>
+    static constexpr unsigned char add_fixed(int_type* dest, const int_type* b, unsigned char c = 0) noexcept
+    {
+        return add_fixed_impl(dest, b, c, std::make_index_sequence<N>{});
+    }
+    /// @brief dest[0, N) -= b[0, N) + c．ループを展開した分岐のない版．
+    /// @return 借り
+    template<std::size_t N>
+    static constexpr unsigned char sub_fixed(int_type* dest, const int_type* b, unsigned char c = 0) noexcept
+    {
+        return sub_fixed_impl(dest, b, c, std::make_index_sequence<N>{});
+    }
+    /// @brief 繰り上がりをdest[0, N)に伝播させる．ループを展開した分岐のない版．
+    template<std::size_t N>
+    static constexpr unsigned char carry_fixed(int_type* dest, unsigned char c) noexcept
+    {
+        return carry_fixed_impl(dest, c, std::make_index_sequence<N>{});
+    }
+    /// @brief 借りをdest[0, N)に伝播させる．ループを展開した分岐のない版．
+    template<std::size_t N>
+    static constexpr unsigned char borrow_fixed(int_type* dest, unsigned char c) noexcept
+    {
+        return borrow_fixed_impl(dest, c, std::make_index_sequence<N>{});
+    }
+    /// @brief 同じ長さの整数の比較．ループを展開した分岐のない版．
+    /// @return a > bなら1, a == bなら0, a < bなら-1
+    template<sign Sign, std::size_t N>
+    static constexpr int cmp_fixed(const int_type* a, const int_type* b) noexcept
+    {
+        return cmp_fixed_impl<Sign>(a, b, std::make_index_sequence<N>{});
+    }
+
     /// @brief 整数同士の足し算．a += bとなり，繰り上がりが返される．
     /// @tparam Digit 整数型(符号なし基本型)
     /// @param a 左辺．
@@ -30,25 +162,28 @@ public:
         a += b;
         return a < b;
     }
+    /// @brief dest[0, destlen)に2桁の整数 c * 2^64 + b を足す．
+    /// @return 繰り上がり
     template<std::random_access_iterator Itr, class Digit>
     static constexpr auto plus(Itr dest, int destlen, Digit b, Digit c = 0u) noexcept
     -> std::enable_if_t<std::is_fundamental_v<Digit> && std::is_unsigned_v<Digit> && std::is_same_v<typename std::iterator_traits<Itr>::value_type, Digit>, bool>
     {
-        if(destlen > 0)
-            c += plus(*dest++, b);
-        for(int i = 1; i < destlen && c; ++i) {
-            c = plus(*dest++, c);
+        if(destlen <= 0) return false;
+        unsigned char cr = addc(0, dest[0], b, dest[0]);
+        if(destlen == 1) return cr | !!c;
+        cr = addc(cr, dest[1], c, dest[1]);
+        for(int i = 2; cr && i < destlen; ++i) {
+            cr = !++dest[i];
         }
-        return c;
+        return cr;
     }
     template<unsigned int Bits, std::integral Digit = typename int_representation<Bits>::coeff_type>
     static constexpr auto plus(int_representation<Bits>& a, Digit b, unsigned int offset_in_coeff = 0) noexcept
     -> std::enable_if_t<std::is_fundamental_v<Digit> && std::is_unsigned_v<Digit>, bool>
     {
-        while(b && offset_in_coeff < a.coeff_length) {
-            b = plus(a.poly[offset_in_coeff++], b);
-        }
-        return b;
+        if(offset_in_coeff >= a.coeff_length) return !!b;
+        const unsigned char cr = addc(0, a.poly[offset_in_coeff], (int_type)b, a.poly[offset_in_coeff]);
+        return carry_n(a.poly.data() + offset_in_coeff + 1, a.coeff_length - offset_in_coeff - 1, cr);
     }
 
     /// @brief addition between 2 int_representation. First argument must have longer or same bit width.
@@ -61,67 +196,106 @@ public:
     static constexpr auto plus(int_representation<Bits1>& a, const int_representation<Bits2>& b) noexcept
     -> std::enable_if_t<(Bits1 >= Bits2), bool>
     {
-        typename int_representation<Bits1>::coeff_type carry = 0;
-        auto i = 0u;
-        for(; i < b.coeff_length; ++i) {
-            typename int_representation<Bits1>::coeff_type bcp = b.poly[i];   
-            carry = plus(a.poly[i], carry);
-            carry |= plus(a.poly[i], bcp);
+#if defined(CHAO_HAS_INT128)
+        if constexpr (Bits1 == 128 && Bits2 == 128) {
+            const auto x = to_native(a);
+            const auto r = x + to_native(b);
+            from_native(a, r);
+            return r < x;
         }
-        for(; carry && i < a.coeff_length; ++i) {
-            carry = plus(a.poly[i], carry);
+#endif
+        if constexpr (a.coeff_length <= unroll_limit) {
+            const unsigned char cr = add_fixed<b.coeff_length>(a.poly.data(), b.poly.data());
+            return carry_fixed<a.coeff_length - b.coeff_length>(a.poly.data() + b.coeff_length, cr);
+        } else {
+            const unsigned char cr = add_n(a.poly.data(), b.poly.data(), b.coeff_length);
+            if constexpr (a.coeff_length == b.coeff_length) return cr;
+            else return carry_n(a.poly.data() + b.coeff_length, a.coeff_length - b.coeff_length, cr);
         }
-        return !!carry;
     }
 
-
+    /// @return 借りが発生しなければtrue
     template<unsigned int Bits, std::integral Digit>
     static constexpr auto minus(int_representation<Bits>& a, Digit b, unsigned int offset_in_coeff = 0) noexcept
     -> std::enable_if_t<std::is_fundamental_v<Digit> && std::is_unsigned_v<Digit>, bool>
     {
-        using digit_t = typename int_representation<Bits>::coeff_type;
-        digit_t carry = 1;
-        unsigned int i;
-        constexpr digit_t expansion = ~0ull;
-        carry = impl_base::plus(a.poly[offset_in_coeff], carry);
-        carry |= impl_base::plus(a.poly[offset_in_coeff], ~b);
-        for(i = offset_in_coeff + 1; i < a.length; ++i) {
-            carry = impl_base::plus(a.poly[i], carry);
-            carry |= impl_base::plus(a.poly[i], expansion);
-        }
-        return carry;
+        if(offset_in_coeff >= a.coeff_length) return !b;
+        const unsigned char br = subb(0, a.poly[offset_in_coeff], (int_type)b, a.poly[offset_in_coeff]);
+        return !borrow_n(a.poly.data() + offset_in_coeff + 1, a.coeff_length - offset_in_coeff - 1, br);
     }
 
-    /// @brief addition between 2 int_representation. First argument must have longer or same bit width.
+    /// @brief subtraction between 2 int_representation. First argument must have longer or same bit width.
     /// @tparam Bits1 bit width of a. Bits1 >= Bits2
     /// @tparam Bits2 bit width of b. Bits2 <= Bits1
     /// @param a integer
     /// @param b integer
-    /// @return carry
+    /// @return 借りが発生しなければtrue
     template<unsigned int Bits1, unsigned int Bits2>
     static constexpr auto minus(int_representation<Bits1>& a, const int_representation<Bits2>& b) noexcept
     -> std::enable_if_t<(Bits1 >= Bits2), bool>
     {
-        using digit_t = typename int_representation<Bits1>::coeff_type;
-        digit_t carry = 1;
-        constexpr digit_t expansion = ~0ull;
-        auto i = 0u;
-        for(; i < b.coeff_length; ++i) {
-            digit_t bcp = b.poly[i];
-            carry = plus(a.poly[i], carry);
-            carry |= plus(a.poly[i], ~bcp);
+#if defined(CHAO_HAS_INT128)
+        if constexpr (Bits1 == 128 && Bits2 == 128) {
+            const auto x = to_native(a), y = to_native(b);
+            from_native(a, x - y);
+            return x >= y;
+        }
+#endif
+        if constexpr (a.coeff_length <= unroll_limit) {
+            const unsigned char br = sub_fixed<b.coeff_length>(a.poly.data(), b.poly.data());
+            return !borrow_fixed<a.coeff_length - b.coeff_length>(a.poly.data() + b.coeff_length, br);
+        } else {
+            const unsigned char br = sub_n(a.poly.data(), b.poly.data(), b.coeff_length);
+            if constexpr (a.coeff_length == b.coeff_length) return !br;
+            else return !borrow_n(a.poly.data() + b.coeff_length, a.coeff_length - b.coeff_length, br);
+        }
+    }
+
+    /// @brief a += b．bが短い場合はSignbに従って符号拡張する．
+    /// @return 繰り上がり
+    template<sign Signb, unsigned int Bits1, unsigned int Bits2>
+    static constexpr auto plus_ext(int_representation<Bits1>& a, const int_representation<Bits2>& b) noexcept
+    -> std::enable_if_t<(Bits1 >= Bits2), bool>
+    {
+        if constexpr (Signb == sign::mp_signed && Bits1 != Bits2) {
+            if(b.msb()) {
+                auto c = add_n(a.poly.data(), b.poly.data(), b.coeff_length);
+                for(auto i = b.coeff_length; i < a.coeff_length; ++i) c = addc(c, a.poly[i], ~(int_type)0, a.poly[i]);
+                return c;
+            }
         }
-        for(; i < a.coeff_length; ++i) {
-            carry = plus(a.poly[i], carry);
-            carry |= plus(a.poly[i], expansion);
+        return plus(a, b);
+    }
+    /// @brief a -= b．bが短い場合はSignbに従って符号拡張する．
+    /// @return 借りが発生しなければtrue
+    template<sign Signb, unsigned int Bits1, unsigned int Bits2>
+    static constexpr auto minus_ext(int_representation<Bits1>& a, const int_representation<Bits2>& b) noexcept
+    -> std::enable_if_t<(Bits1 >= Bits2), bool>
+    {
+        if constexpr (Signb == sign::mp_signed && Bits1 != Bits2) {
+            if(b.msb()) {
+                auto c = sub_n(a.poly.data(), b.poly.data(), b.coeff_length);
+                for(auto i = b.coeff_length; i < a.coeff_length; ++i) c = subb(c, a.poly[i], ~(int_type)0, a.poly[i]);
+                return !c;
+            }
         }
-        return !!carry;
+        return minus(a, b);
+    }
+    /// @brief a = -a
+    template<unsigned int Bits>
+    static constexpr void negate(int_representation<Bits>& a) noexcept
+    {
+        unsigned char br = 0;
+        for(auto& d : a.poly) br = subb(br, 0, d, d);
     }
 
     template<sign Sign, unsigned int Len1, unsigned int Len2>
     static constexpr auto cmp(const int_type* a, const int_type* b) noexcept
     -> std::enable_if_t<(Len1 >= Len2), int>
     {
+        if constexpr (Len1 == Len2 && Len1 <= unroll_limit) {
+            return cmp_fixed<Sign, Len1>(a, b);
+        }
         auto msb = [](const int_type *t, unsigned int len)
         {
             return t[len - 1] >> (sizeof(int_type) * 8 - 1);
@@ -148,12 +322,23 @@ public:
     static constexpr auto cmp(const int_type* a, const int_type* b) noexcept
     -> std::enable_if_t<(Len2 > Len1), int>
     {
-        -cmp<Sign, Len2, Len1>(b, a);
+        return -cmp<Sign, Len2, Len1>(b, a);
     }
     template<sign Sign, unsigned int Bits1, unsigned int Bits2>
     static constexpr auto cmp(const int_representation<Bits1>& a, const int_representation<Bits2>& b) noexcept
     -> std::enable_if_t<(Bits1 >= Bits2), int>
     {
+#if defined(CHAO_HAS_INT128)
+        if constexpr (Bits1 == 128 && Bits2 == 128) {
+            if constexpr (Sign == sign::mp_signed) {
+                const auto x = (native_int128)to_native(a), y = (native_int128)to_native(b);
+                return (x > y) - (x < y);
+            } else {
+                const auto x = to_native(a), y = to_native(b);
+                return (x > y) - (x < y);
+            }
+        }
+#endif
         return cmp<Sign, a.length, b.length>(a.poly.data(), b.poly.data());
     }
     template<sign Sign, unsigned int Bits1, unsigned int Bits2>
@@ -162,6 +347,43 @@ public:
     {
         return -cmp<Sign>(b, a);
     }
+
+private:
+    template<std::size_t ...I>
+    static constexpr unsigned char add_fixed_impl(int_type* dest, const int_type* b, unsigned char c, std::index_sequence<I...>) noexcept
+    {
+        ((c = addc(c, dest[I], b[I], dest[I])), ...);
+        return c;
+    }
+    template<std::size_t ...I>
+    static constexpr unsigned char sub_fixed_impl(int_type* dest, const int_type* b, unsigned char c, std::index_sequence<I...>) noexcept
+    {
+        ((c = subb(c, dest[I], b[I], dest[I])), ...);
+        return c;
+    }
+    template<std::size_t ...I>
+    static constexpr unsigned char carry_fixed_impl(int_type* dest, unsigned char c, std::index_sequence<I...>) noexcept
+    {
+        ((c = addc(c, dest[I], 0, dest[I])), ...);
+        return c;
+    }
+    template<std::size_t ...I>
+    static constexpr unsigned char borrow_fixed_impl(int_type* dest, unsigned char c, std::index_sequence<I...>) noexcept
+    {
+        ((c = subb(c, dest[I], 0, dest[I])), ...);
+        return c;
+    }
+    template<sign Sign, std::size_t ...I>
+    static constexpr int cmp_fixed_impl(const int_type* a, const int_type* b, std::index_sequence<I...>) noexcept
+    {
+        // 符号付きなら最上位桁の符号ビットを反転させて符号なしとして比較する
+        constexpr std::size_t top = sizeof...(I) - 1;
+        constexpr int_type flip = (int_type)(Sign == sign::mp_signed) << (sizeof(int_type) * CHAR_BIT - 1);
+        unsigned char br = 0;
+        int_type ne = 0, d;
+        ((br = subb(br, a[I] ^ (I == top ? flip : 0), b[I] ^ (I == top ? flip : 0), d), ne |= d), ...);
+        return (int)!!ne - 2 * (int)br;
+    }
 };
 
 class bitop{
@@ -231,50 +453,210 @@ public:
             }
         }
     }
-    template<sign Sign, unsigned int Bits>
-    static constexpr void shiftr(int_representation<Bits>& a, unsigned int width) noexcept
+    /// @brief (hi:lo) >> rの下位桁(shrd)．0 <= r < 64
+    static constexpr impl_base::int_type shrd(impl_base::int_type lo, impl_base::int_type hi, unsigned int r) noexcept
+    {
+#if defined(CHAO_HAS_INT128)
+        return (impl_base::int_type)((((native_uint128)hi << 64) | lo) >> r);
+#else
+        return (lo >> r) | ((hi << 1) << (63 - r));
+#endif
+    }
+    /// @brief (hi:lo) << rの上位桁(shld)．0 <= r < 64
+    static constexpr impl_base::int_type shld(impl_base::int_type hi, impl_base::int_type lo, unsigned int r) noexcept
     {
-        using ctype = typename int_representation<Bits>::coeff_type;
-        constexpr auto coeff_width = sizeof(typename int_representation<Bits>::coeff_type) * CHAR_BIT;
-        typename int_representation<Bits>::coeff_type buff0 = 0, buff1;
-        const auto offset = width / coeff_width; // qword
-        const auto remain = width & (coeff_width - 1);
-        int i = a.coeff_length - offset;
+#if defined(CHAO_HAS_INT128)
+        return (impl_base::int_type)(((((native_uint128)hi << 64) | lo) << r) >> 64);
+#else
+        return (hi << r) | ((lo >> 1) >> (63 - r));
+#endif
+    }
 
-        buff0 = ~((ctype)(Sign == sign::mp_signed && a.msb()) - 1) << (coeff_width - remain);
-        if(offset) {
-            std::copy(a.poly.data() + offset, a.poly.data() + (a.coeff_length), a.poly.data());
-            std::fill_n(a.poly.data() + a.coeff_length - offset, offset, buff0 ? ~0 : 0);
+    /// @brief a[0, len) >>= width．各桁を一度だけ読む．上位はfillで埋められる．
+    static constexpr void shiftr_n(impl_base::int_type* a, unsigned int len, unsigned int width, impl_base::int_type fill) noexcept
+    {
+        constexpr unsigned int w = sizeof(impl_base::int_type) * CHAR_BIT;
+        const unsigned int off = width / w, r = width % w;
+        if(off >= len) {
+            std::fill_n(a, len, fill);
+            return;
+        }
+        const unsigned int n = len - off;
+        if(r == 0) {
+            for(auto i = 0u; i < n; ++i) a[i] = a[i + off];
+        } else {
+            auto lo = a[off];
+            for(auto i = 0u; i + 1 < n; ++i) {
+                const auto hi = a[i + off + 1];
+                a[i] = shrd(lo, hi, r);
+                lo = hi;
+            }
+            a[n - 1] = shrd(lo, fill, r);
         }
-        while(remain && i-->0) {
-            buff1 = a.poly[i] << (coeff_width - remain);
-            a.poly[i] >>= remain;
-            a.poly[i] |= buff0;
-            buff0 = buff1;
+        std::fill_n(a + n, off, fill);
+    }
+    /// @brief a[0, len) <<= width．各桁を一度だけ読む．
+    static constexpr void shiftl_n(impl_base::int_type* a, unsigned int len, unsigned int width) noexcept
+    {
+        constexpr unsigned int w = sizeof(impl_base::int_type) * CHAR_BIT;
+        const unsigned int off = width / w, r = width % w;
+        if(off >= len) {
+            std::fill_n(a, len, (impl_base::int_type)0);
+            return;
         }
+        if(r == 0) {
+            for(auto i = len; i-- > off;) a[i] = a[i - off];
+        } else {
+            auto hi = a[len - 1 - off];
+            for(auto i = len - 1; i > off; --i) {
+                const auto lo = a[i - off - 1];
+                a[i] = shld(hi, lo, r);
+                hi = lo;
+            }
+            a[off] = hi << r;
+        }
+        std::fill_n(a, off, (impl_base::int_type)0);
     }
-    template<sign Sign = sign::mp_unsigned, unsigned int Bits>
-    static constexpr void shiftl(int_representation<Bits>& a, unsigned int width) noexcept
+    /// @brief a = (a << 1) | in．adcの連鎖で1パスで処理する．
+    /// @return 押し出された最上位ビット
+    template<unsigned int Bits>
+    static constexpr bool shiftl1(int_representation<Bits>& a, bool in = false) noexcept
     {
-        constexpr auto coeff_width = sizeof(typename int_representation<Bits>::coeff_type) * CHAR_BIT;
-        typename int_representation<Bits>::coeff_type buff0 = 0, buff1;
-        const auto offset = width >> std::countr_zero(coeff_width); // qword
-        const auto remain = width & (coeff_width - 1);
-        static_assert(std::has_single_bit(coeff_width));
+        unsigned char c = in;
+        for(auto& d : a.poly) c = impl_base::addc(c, d, d, d);
+        return c;
+    }
 
-        if(offset) {
-            // std::memcpy(a.poly.data() + offset, a.poly.data(), (a.coeff_length - offset) * sizeof(typename int_representation<Bits>::coeff_type));
-            std::copy_backward(a.poly.data(), a.poly.data() + (a.coeff_length - offset), a.poly.end());
-            // std::memset(a.poly.data(), 0, offset * sizeof(typename int_representation<Bits>::coeff_type));
-            std::fill_n(a.poly.data(), offset, 0);
+    /// @brief Bitsビットの値を表す桁の列a >>= width．上位はSignに従って符号または0で埋める．
+    template<sign Sign, unsigned int Bits>
+    static constexpr void shiftr_limbs(impl_base::int_type* a, unsigned int width) noexcept
+    {
+        constexpr unsigned int len = int_representation<Bits>::coeff_length;
+#if defined(CHAO_HAS_INT128)
+        if constexpr (Bits == 128) {
+            const native_uint128 x = (native_uint128)a[1] << 64 | a[0];
+            native_uint128 r;
+            if constexpr (Sign == sign::mp_signed) {
+                r = (native_uint128)((native_int128)x >> std::min(width, 127u));
+            } else {
+                r = width < 128 ? x >> width : 0;
+            }
+            a[0] = (impl_base::int_type)r;
+            a[1] = (impl_base::int_type)(r >> 64);
+            return;
+        }
+#endif
+        if constexpr (len <= impl_base::unroll_limit) {
+            shiftr_fixed<len>(a, width, fill_bits<Sign>(msb_of_limbs<Bits>(a)));
+        } else {
+            shiftr_n(a, len, width, fill_bits<Sign>(msb_of_limbs<Bits>(a)));
+        }
+    }
+    /// @brief Bitsビットの値を表す桁の列a <<= width
+    template<unsigned int Bits>
+    static constexpr void shiftl_limbs(impl_base::int_type* a, unsigned int width) noexcept
+    {
+        constexpr unsigned int len = int_representation<Bits>::coeff_length;
+#if defined(CHAO_HAS_INT128)
+        if constexpr (Bits == 128) {
+            const native_uint128 x = (native_uint128)a[1] << 64 | a[0];
+            const native_uint128 r = width < 128 ? x << width : 0;
+            a[0] = (impl_base::int_type)r;
+            a[1] = (impl_base::int_type)(r >> 64);
+            return;
         }
-        for(auto i = 0u; i < a.coeff_length && remain; ++i) {
-            buff1 = a.poly[i] >> (coeff_width - remain);
-            a.poly[i] = a.poly[i] << remain;
-            a.poly[i] |= buff0;
-            buff0 = buff1;
+#endif
+        if constexpr (len <= impl_base::unroll_limit) {
+            shiftl_fixed<len>(a, width);
+        } else {
+            shiftl_n(a, len, width);
         }
     }
+    /// @brief シフト幅がコンパイル時定数の，桁の列a[0, Len)の左シフト
+    template<unsigned int Width, unsigned int Len>
+    static constexpr void shiftl_const(impl_base::int_type* a) noexcept
+    {
+        if constexpr (Width == 0) {
+        } else if constexpr (Width == 1) {
+            unsigned char c = 0;
+            for(auto i = 0u; i < Len; ++i) c = impl_base::addc(c, a[i], a[i], a[i]);
+        } else {
+            shiftl_n(a, Len, Width);
+        }
+    }
+    /// @brief シフト幅がコンパイル時定数の，Bitsビットの値を表す桁の列aの右シフト
+    template<sign Sign, unsigned int Width, unsigned int Bits>
+    static constexpr void shiftr_const(impl_base::int_type* a) noexcept
+    {
+        if constexpr (Width != 0) {
+            shiftr_n(a, int_representation<Bits>::coeff_length, Width, fill_bits<Sign>(msb_of_limbs<Bits>(a)));
+        }
+    }
+
+    template<sign Sign, unsigned int Bits>
+    static constexpr void shiftr(int_representation<Bits>& a, unsigned int width) noexcept
+    {
+        shiftr_limbs<Sign, Bits>(a.poly.data(), width);
+    }
+    template<sign Sign = sign::mp_unsigned, unsigned int Bits>
+    static constexpr void shiftl(int_representation<Bits>& a, unsigned int width) noexcept
+    {
+        shiftl_limbs<Bits>(a.poly.data(), width);
+    }
+    /// @brief シフト幅がコンパイル時定数の左シフト
+    template<unsigned int Width, unsigned int Bits>
+    static constexpr void shiftl(int_representation<Bits>& a) noexcept
+    {
+        shiftl_const<Width, int_representation<Bits>::coeff_length>(a.poly.data());
+    }
+    /// @brief シフト幅がコンパイル時定数の右シフト
+    template<sign Sign, unsigned int Width, unsigned int Bits>
+    static constexpr void shiftr(int_representation<Bits>& a) noexcept
+    {
+        shiftr_const<Sign, Width, Bits>(a.poly.data());
+    }
+
+    /// @brief a[0, N) <<= width．ループを展開した分岐のない版．
+    template<std::size_t N>
+    static constexpr void shiftl_fixed(impl_base::int_type* a, unsigned int width) noexcept
+    {
+        shiftl_fixed_impl(a, width, std::make_index_sequence<N>{});
+    }
+    /// @brief a[0, N) >>= width．上位はfillで埋められる．ループを展開した分岐のない版．
+    template<std::size_t N>
+    static constexpr void shiftr_fixed(impl_base::int_type* a, unsigned int width, impl_base::int_type fill) noexcept
+    {
+        shiftr_fixed_impl(a, width, fill, std::make_index_sequence<N>{});
+    }
+private:
+    template<std::size_t ...I>
+    static constexpr void shiftl_fixed_impl(impl_base::int_type* a, unsigned int width, std::index_sequence<I...>) noexcept
+    {
+        using int_type = impl_base::int_type;
+        constexpr std::size_t N = sizeof...(I);
+        constexpr unsigned int w = sizeof(int_type) * CHAR_BIT;
+        // z = {0 (N + 1 digits), a[0], ..., a[N - 1]}
+        int_type z[2 * N + 1] = {};
+        ((z[N + 1 + I] = a[I]), ...);
+        const std::size_t off = std::min<std::size_t>(width / w, N);
+        const unsigned int r = width % w;
+        ((a[I] = (z[N + 1 + I - off] << r) | ((z[N + I - off] >> 1) >> (w - 1 - r))), ...);
+    }
+    template<std::size_t ...I>
+    static constexpr void shiftr_fixed_impl(impl_base::int_type* a, unsigned int width, impl_base::int_type fill, std::index_sequence<I...>) noexcept
+    {
+        using int_type = impl_base::int_type;
+        constexpr std::size_t N = sizeof...(I);
+        constexpr unsigned int w = sizeof(int_type) * CHAR_BIT;
+        // z = {a[0], ..., a[N - 1], fill (N + 1 digits)}
+        int_type z[2 * N + 1];
+        ((z[I] = a[I]), ...);
+        ((z[N + I] = fill), ...);
+        z[2 * N] = fill;
+        const std::size_t off = std::min<std::size_t>(width / w, N);
+        const unsigned int r = width % w;
+        ((a[I] = (z[I + off] >> r) | ((z[I + off + 1] << 1) << (w - 1 - r))), ...);
+    }
 };
 
 class naive_mul {
@@ -290,6 +672,13 @@ public:
     static constexpr auto mul(Digit& dest, Digit a, Digit b) noexcept
     -> std::enable_if_t<std::is_unsigned_v<Digit>, Digit>
     {
+#if defined(CHAO_HAS_INT128)
+        if constexpr (sizeof(Digit) == sizeof(std::uint64_t)) {
+            const native_uint128 p = (native_uint128)a * b;
+            dest = (Digit)p;
+            return (Digit)(p >> 64);
+        }
+#endif
         constexpr unsigned int half_bit_width = sizeof(Half) * CHAR_BIT;
         const Digit ah[] = {static_cast<Half>(a), static_cast<Half>(a >> half_bit_width)};
         const Digit bh[] = {static_cast<Half>(b), static_cast<Half>(b >> half_bit_width)};
@@ -305,6 +694,10 @@ public:
     -> std::enable_if_t<std::is_same_v<typename std::iterator_traits<Itr>::value_type, typename std::iterator_traits<CItr>::value_type>, void>
     {
         typedef typename std::iterator_traits<Itr>::value_type int_type;
+        if constexpr (std::is_pointer_v<Itr> && std::is_same_v<int_type, impl_base::int_type> && MulLen <= (int)impl_base::unroll_limit) {
+            mul_fixed<DestLen, MulLen>(dest, &*a, &*b);
+            return;
+        }
         int_type digit, c;
         std::fill_n(dest, DestLen, (int_type)0);
         // for(auto i = 0; i < std::min(DestLen, 2 * MulLen); ++i) {
@@ -326,17 +719,176 @@ public:
         }
     }
 
+    /// @brief dest[0, len) += a[0, len) * b
+    /// @return 上位に溢れた桁
+    static constexpr impl_base::int_type addmul_1(impl_base::int_type* dest, const impl_base::int_type* a, unsigned int len, impl_base::int_type b) noexcept
+    {
+        impl_base::int_type c = 0;
+        for(auto i = 0u; i < len; ++i) {
+            impl_base::int_type lo;
+            impl_base::int_type hi = mul(lo, a[i], b);
+            hi += impl_base::plus(lo, c);
+            hi += impl_base::plus(lo, dest[i]);
+            dest[i] = lo;
+            c = hi;
+        }
+        return c;
+    }
+    /// @brief dest[0, destlen) = a[0, la) * b[0, lb)．桁数を実行時に与える筆算で，0の桁の行は飛ばす．
+    static constexpr void mul_n(impl_base::int_type* dest, unsigned int destlen, const impl_base::int_type* a, unsigned int la, const impl_base::int_type* b, unsigned int lb) noexcept
+    {
+        std::fill_n(dest, destlen, (impl_base::int_type)0);
+        for(auto i = 0u; i < std::min(la, destlen); ++i) {
+            if(!a[i]) continue;
+            const auto n = std::min(lb, destlen - i);
+            const auto c = addmul_1(dest + i, b, n, a[i]);
+            if(i + n < destlen) dest[i + n] = c;
+        }
+    }
+    /// @brief dest[0, len) -= a[0, len) * b
+    /// @return dest[len]から引くべき桁
+    static constexpr impl_base::int_type submul_1(impl_base::int_type* dest, const impl_base::int_type* a, unsigned int len, impl_base::int_type b) noexcept
+    {
+        impl_base::int_type c = 0;
+        for(auto i = 0u; i < len; ++i) {
+            impl_base::int_type lo;
+            impl_base::int_type hi = mul(lo, a[i], b);
+            hi += impl_base::plus(lo, c);
+            hi += impl_base::subb(0, dest[i], lo, dest[i]);
+            c = hi;
+        }
+        return c;
+    }
+    /// @brief (hi:lo) / d．hi < dでなければならない．
+    /// @return 商
+    static constexpr impl_base::int_type div_2by1(impl_base::int_type hi, impl_base::int_type lo, impl_base::int_type d, impl_base::int_type& r) noexcept
+    {
+        assert(hi < d);
+#if defined(CHAO_HAS_INT128)
+        const native_uint128 t = ((native_uint128)hi << 64) | lo;
+        r = (impl_base::int_type)(t % d);
+        return (impl_base::int_type)(t / d);
+#else
+        impl_base::int_type q = 0;
+        for(auto i = 0; i < 64; ++i) {
+            const bool top = hi >> 63;
+            hi = (hi << 1) | (lo >> 63);
+            lo <<= 1;
+            q <<= 1;
+            if(top || hi >= d) {
+                hi -= d;
+                q |= 1;
+            }
+        }
+        r = hi;
+        return q;
+#endif
+    }
+    /// @brief q[0, len) = a[0, len) / d (1桁の整数)
+    /// @return 余り
+    static constexpr impl_base::int_type div_1(impl_base::int_type* q, const impl_base::int_type* a, unsigned int len, impl_base::int_type d) noexcept
+    {
+        impl_base::int_type r = 0;
+        for(auto i = len; i-- > 0;) q[i] = div_2by1(r, a[i], d, r);
+        return r;
+    }
+    static constexpr unsigned int div_n_scratch(unsigned int la, unsigned int lb) noexcept { return la + lb + 1; }
+    /// @brief q[0, la-lb+1) = a[0, la) / b[0, lb)，r[0, lb) = a % b．Knuth Algorithm D．
+    /// la >= lb >= 1かつb[lb-1] != 0でなければならない．scratchにはdiv_n_scratch(la, lb)桁必要．
+    static constexpr void div_n(impl_base::int_type* q, impl_base::int_type* r, const impl_base::int_type* a, unsigned int la, const impl_base::int_type* b, unsigned int lb, impl_base::int_type* scratch) noexcept
+    {
+        using int_type = impl_base::int_type;
+        assert(la >= lb && lb >= 1 && b[lb - 1] != 0);
+        if(lb == 1) {
+            r[0] = div_1(q, a, la, b[0]);
+            return;
+        }
+        // 除数の最上位ビットが立つように正規化する
+        const unsigned int s = std::countl_zero(b[lb - 1]);
+        int_type* vn = scratch;
+        int_type* un = scratch + lb;
+        std::copy(b, b + lb, vn);
+        bitop::shiftl_n(vn, lb, s);
+        std::copy(a, a + la, un);
+        un[la] = s ? a[la - 1] >> (64 - s) : 0;
+        bitop::shiftl_n(un, la, s);
+        const int_type d1 = vn[lb - 1], d0 = vn[lb - 2];
+        for(auto j = la - lb + 1; j-- > 0;) {
+            const int_type u2 = un[j + lb], u1 = un[j + lb - 1], u0 = un[j + lb - 2];
+            int_type qhat, rhat;
+            bool rhat_overflow = false;
+            if(u2 >= d1) {
+                qhat = ~(int_type)0;
+                rhat_overflow = impl_base::addc(0, u1, d1, rhat);
+            } else {
+                qhat = div_2by1(u2, u1, d1, rhat);
+            }
+            while(!rhat_overflow) {
+                int_type lo;
+                const int_type hi = mul(lo, qhat, d0);
+                if(hi < rhat || (hi == rhat && lo <= u0)) break;
+                --qhat;
+                rhat_overflow = impl_base::addc(0, rhat, d1, rhat);
+            }
+            const int_type c = submul_1(un + j, vn, lb, qhat);
+            if(impl_base::subb(0, un[j + lb], c, un[j + lb])) {
+                // 推定した商が1大きかったので足し戻す
+                --qhat;
+                un[j + lb] += impl_base::add_n(un + j, vn, lb);
+            }
+            q[j] = qhat;
+        }
+        std::copy(un, un + lb, r);
+        bitop::shiftr_n(r, lb, s, 0);
+        if(s) r[lb - 1] |= un[lb] << (64 - s);
+    }
+
+    /// @brief a *= b (1桁の整数)．その場で計算する．
+    /// @return 上位に溢れた桁
+    static constexpr impl_base::int_type mul_1(impl_base::int_type* a, unsigned int len, impl_base::int_type b) noexcept
+    {
+        impl_base::int_type c = 0;
+        for(auto i = 0u; i < len; ++i) {
+            impl_base::int_type lo;
+            impl_base::int_type hi = mul(lo, a[i], b);
+            hi += impl_base::plus(lo, c);
+            a[i] = lo;
+            c = hi;
+        }
+        return c;
+    }
+    template<unsigned int Bits>
+    static constexpr auto mul_1(int_representation<Bits>& a, impl_base::int_type b) noexcept
+    -> impl_base::int_type
+    {
+        return mul_1(a.poly.data(), a.coeff_length, b);
+    }
+
+    /// @brief dest[0, DestLen) = a[0, Len) * b[0, Len)．ループを展開した行単位の筆算．
+    template<int DestLen, int Len>
+    static constexpr void mul_fixed(impl_base::int_type* dest, const impl_base::int_type* a, const impl_base::int_type* b) noexcept
+    {
+        std::fill_n(dest, DestLen, (impl_base::int_type)0);
+        mul_fixed_rows<DestLen, Len>(dest, a, b, std::make_index_sequence<Len>{});
+    }
+
     template<unsigned int Bits, unsigned int Bits1, unsigned int Bits2>
     static constexpr auto mul(int_representation<Bits>& dest, const int_representation<Bits1>& a, const int_representation<Bits2>& b) noexcept
     -> std::enable_if_t<(Bits >= Bits1 && Bits1 >= Bits2), void>
     {
+#if defined(CHAO_HAS_INT128)
+        if constexpr (Bits == 128 && Bits1 == 128 && Bits2 == 128) {
+            from_native(dest, to_native(a) * to_native(b));
+            return;
+        }
+#endif
         typename int_representation<Bits>::coeff_type digit;
         dest.flush();
         for(auto i = 0u; i < std::min(dest.coeff_length, a.coeff_length + b.coeff_length); ++i) {
             for(auto j = 0u; j <= std::min(i, b.coeff_length - 1); ++j) {
                 auto k = i - j;
-                impl_base::plus(dest, mul(digit, a.poly[k], b.poly[j]), i + 1);
-                impl_base::plus(dest, digit, i);
+                const auto c = mul(digit, a.poly[k], b.poly[j]);
+                impl_base::plus(dest.poly.data() + i, dest.coeff_length - i, digit, c);
             }
         }
     }
@@ -359,8 +911,32 @@ public:
     static constexpr auto div(int_representation<Bits>& quotient, int_representation<Bits>& remainder, const int_representation<Bits>& dividend, const int_representation<Bits>& divisor) noexcept
     -> std::enable_if_t<Sign == sign::mp_signed>
     {
+#if defined(CHAO_HAS_INT128)
+        if constexpr (Bits == 128) {
+            const auto x = (native_int128)to_native(dividend), y = (native_int128)to_native(divisor);
+            // 0除算とオーバーフローはビット単位の実装に任せる
+            if(y != 0 && !(y == -1 && to_native(dividend) == (native_uint128)1 << 127)) {
+                from_native(quotient, (native_uint128)(x / y));
+                from_native(remainder, (native_uint128)(x % y));
+                return;
+            }
+        }
+#endif
+        if(impl_base::active_length(divisor)) {
+            // 絶対値の符号なし除算に帰着させ，実際の桁数に応じた方法で計算する
+            const bool na = dividend.msb(), nb = divisor.msb();
+            auto a = dividend;
+            auto b = divisor;
+            if(na) impl_base::negate(a);
+            if(nb) impl_base::negate(b);
+            div<sign::mp_unsigned>(quotient, remainder, a, b);
+            if(na != nb) impl_base::negate(quotient);
+            if(na) impl_base::negate(remainder);
+            return;
+        }
         // https://lpha-z.hatenablog.com/entry/2018/11/11/231500
-        constexpr auto N = Bits;
+        // 余りのビットも符号拡張されているので桁全体の幅で計算する
+        constexpr auto N = int_representation<Bits>::coeff_length * 64;
         quotient.flush();
         remainder = dividend.msb() ? -1 : 0;
 
@@ -368,25 +944,21 @@ public:
             //bool new_bit = dividend & 1ull<<i;
             bool new_bit = dividend.bitat(i);
             if( (remainder.msb()) != (divisor.msb()) ) {
-                bitop::shiftl(quotient, 1);
+                bitop::shiftl1(quotient);
                 // remainder = ((remainder<<1) | new_bit) + divisor;
-                bitop::shiftl(remainder, 1);
-                remainder.poly[0] |= new_bit;
+                bitop::shiftl1(remainder, new_bit);
                 impl_base::plus(remainder, divisor);
             } else {
                 // quotient = (quotient<<1) | 1;
-                bitop::shiftl(quotient, 1);
-                quotient.poly[0] |= 1;
+                bitop::shiftl1(quotient, true);
                 // remainder = ((remainder<<1) | new_bit) - divisor;
-                bitop::shiftl(remainder, 1);
-                remainder.poly[0] |= new_bit;
+                bitop::shiftl1(remainder, new_bit);
                 impl_base::minus(remainder, divisor);
             }
         }
 
         // quotient = (quotient << 1) | 1;
-        bitop::shiftl(quotient, 1);
-        quotient.poly[0] |= 1;
+        bitop::shiftl1(quotient, true);
         if( (bool)remainder == false ) {
             /* do nothing */
         } else if( impl_base::cmp<sign::mp_signed>(remainder, divisor) == 0 ) {
@@ -417,14 +989,41 @@ public:
     static constexpr auto div(int_representation<Bits>& quotient, int_representation<Bits>& remainder, const int_representation<Bits>& dividend, const int_representation<Bits>& divisor) noexcept
     -> std::enable_if_t<Sign == sign::mp_unsigned>
     {
-        // https://lpha-z.hatenablog.com/entry/2018/11/04/231500
-        constexpr auto N = Bits;
+#if defined(CHAO_HAS_INT128)
+        if constexpr (Bits == 128) {
+            const auto x = to_native(dividend), y = to_native(divisor);
+            if(y != 0) {
+                from_native(quotient, x / y);
+                from_native(remainder, x % y);
+                return;
+            }
+        }
+#endif
+        const auto ld = impl_base::active_length(divisor);
         remainder.flush();
         quotient.flush();
-        for( int i = N-1; i >= 0; --i ) {
-            bitop::shiftl(quotient, 1);
-            bitop::shiftl(remainder, 1);
-            remainder.poly[0] |= dividend.bitat(i);
+        if(ld == 1) {
+            remainder.poly[0] = div_1(quotient.poly.data(), dividend.poly.data(), impl_base::active_length(dividend), divisor.poly[0]);
+            return;
+        }
+        if(ld) {
+            // 実際の桁数だけでKnuth Dを行う
+            constexpr auto len = int_representation<Bits>::coeff_length;
+            const auto la = impl_base::active_length(dividend);
+            if(la < ld) {
+                remainder = dividend;
+                return;
+            }
+            impl_base::int_type scratch[div_n_scratch(len, len)] = {};
+            div_n(quotient.poly.data(), remainder.poly.data(), dividend.poly.data(), la, divisor.poly.data(), ld, scratch);
+            return;
+        }
+        // 0除算はビット単位の実装での結果を保つ
+        // https://lpha-z.hatenablog.com/entry/2018/11/04/231500
+        constexpr auto N = int_representation<Bits>::coeff_length * 64;
+        for( int i = (int)N - 1; i >= 0; --i ) {
+            bitop::shiftl1(quotient);
+            bitop::shiftl1(remainder, dividend.bitat(i));
 
             // const lbl::uintN_t<N+1> test_sub = static_cast<lbl::uintN_t<N+1>>(remainder) - static_cast<lbl::uintN_t<N+1>>(divisor);
             auto test_sub = remainder;
@@ -435,6 +1034,136 @@ public:
             if(success) remainder = test_sub;
         }
     }
+    /// @brief q = a / b，r = a % b．桁はいずれもint_representation<Bits>::length個．
+    /// 被演算子が共に非負なら桁を写さずにdiv_1/div_nで割り，負の値や0除算はint_representationに写してdivに任せる．
+    /// q，rはa，bと重なってはならない．
+    template<sign Sign, unsigned int Bits>
+    static constexpr void div_limbs(impl_base::int_type* q, impl_base::int_type* r, const impl_base::int_type* a, const impl_base::int_type* b) noexcept
+    {
+        constexpr auto len = int_representation<Bits>::coeff_length;
+        const bool negative = Sign == sign::mp_signed && (msb_of_limbs<Bits>(a) || msb_of_limbs<Bits>(b));
+        const auto ld = impl_base::active_length(b, len);
+#if defined(CHAO_HAS_INT128)
+        constexpr bool native = Bits == 128;
+#else
+        constexpr bool native = false;
+#endif
+        if(!native && !negative && ld) {
+            std::fill_n(q, len, 0);
+            std::fill_n(r, len, 0);
+            const auto la = impl_base::active_length(a, len);
+            if(ld == 1) {
+                r[0] = div_1(q, a, la, b[0]);
+            } else if(la < ld) {
+                std::copy_n(a, len, r);
+            } else {
+                impl_base::int_type scratch[div_n_scratch(len, len)] = {};
+                div_n(q, r, a, la, b, ld, scratch);
+            }
+            return;
+        }
+        int_representation<Bits> x, y, quotient, remainder;
+        std::copy_n(a, len, x.poly.data());
+        std::copy_n(b, len, y.poly.data());
+        div<Sign, Bits>(quotient, remainder, x, y);
+        std::copy_n(quotient.poly.data(), len, q);
+        std::copy_n(remainder.poly.data(), len, r);
+    }
+
+private:
+    template<int DestLen, int Len, std::size_t ...I>
+    static constexpr void mul_fixed_rows(impl_base::int_type* dest, const impl_base::int_type* a, const impl_base::int_type* b, std::index_sequence<I...>) noexcept
+    {
+        (mul_fixed_row<DestLen, Len, I>(dest, a[I], b, std::make_index_sequence<Len>{}), ...);
+    }
+    template<int DestLen, int Len, std::size_t I, std::size_t ...J>
+    static constexpr void mul_fixed_row(impl_base::int_type* dest, impl_base::int_type ai, const impl_base::int_type* b, std::index_sequence<J...>) noexcept
+    {
+        if constexpr ((int)I < DestLen) {
+            impl_base::int_type c = 0;
+            (mul_fixed_step<DestLen, I + J>(dest, ai, b[J], c), ...);
+            if constexpr ((int)I + Len < DestLen) dest[I + Len] = c;
+        }
+    }
+    template<int DestLen, std::size_t K>
+    static constexpr void mul_fixed_step(impl_base::int_type* dest, impl_base::int_type a, impl_base::int_type b, impl_base::int_type& c) noexcept
+    {
+        if constexpr ((int)K < DestLen) {
+            impl_base::int_type lo;
+            impl_base::int_type hi = mul(lo, a, b);
+            hi += impl_base::plus(lo, c);
+            hi += impl_base::plus(lo, dest[K]);
+            dest[K] = lo;
+            c = hi;
+        }
+    }
+};
+
+/// @brief R = 2^(64*N)のMontgomery乗算．積と簡約を語ごとに交互に行う(CIOS)ので，
+/// 1回の乗算は約2N^2回の桁の積で済み，全幅の積やマスク，シフトを作らない．
+/// @tparam N 法の桁数
+template<unsigned int N>
+class montgomery {
+public:
+    using int_type = impl_base::int_type;
+
+    /// @brief -m^-1 mod 2^64．m0は奇数であること．ニュートン法で正しいビット数を倍々にする．
+    static constexpr int_type neg_inv(int_type m0) noexcept
+    {
+        // 奇数mについてm*m = 1 (mod 8)なので，初期値で3ビットは正しい
+        int_type x = m0;
+        for(int i = 0; i < 5; ++i) x *= 2 - m0 * x;
+        return (int_type)0 - x;
+    }
+    /// @brief r = a * b * R^-1 mod m．a < R, b < mのときr < m．rはa, bと同じでもよい．
+    /// Reduceがfalseなら最後の引き算を省き，a, b < 2m, 4m <= Rのときr < 2mとなる．
+    /// @param m_dash neg_inv(m[0])
+    template<bool Reduce = true>
+    static constexpr void mul(int_type* r, const int_type* a, const int_type* b, const int_type* m, int_type m_dash) noexcept
+    {
+        int_type t[N + 2] = {};
+        for(auto i = 0u; i < N; ++i) {
+            // t += a[i] * b
+            int_type c = 0;
+            for(auto j = 0u; j < N; ++j) c = muladd(t[j], a[i], b[j], c);
+            t[N + 1] = impl_base::plus(t[N], c);
+            // t += q * m (t[0]が0になる)として，1語右にずらす
+            const int_type q = t[0] * m_dash;
+            int_type lo = t[0];
+            c = muladd(lo, q, m[0], 0);
+            for(auto j = 1u; j < N; ++j) {
+                t[j - 1] = t[j];
+                c = muladd(t[j - 1], q, m[j], c);
+            }
+            t[N - 1] = t[N];
+            t[N] = t[N + 1] + impl_base::plus(t[N - 1], c);
+        }
+        // t < 2m
+        if constexpr (Reduce) {
+            if(t[N] || !less(t, m)) impl_base::sub_n(t, m, N);
+        }
+        std::copy_n(t, N, r);
+    }
+
+private:
+    /// @brief d = d + a * b + cの下位の桁
+    /// @return 上位の桁
+    static constexpr int_type muladd(int_type& d, int_type a, int_type b, int_type c) noexcept
+    {
+        int_type lo;
+        int_type hi = naive_mul::mul(lo, a, b);
+        hi += impl_base::plus(lo, c);
+        hi += impl_base::plus(lo, d);
+        d = lo;
+        return hi;
+    }
+    static constexpr bool less(const int_type* a, const int_type* b) noexcept
+    {
+        for(auto i = N; i-- > 0;) {
+            if(a[i] != b[i]) return a[i] < b[i];
+        }
+        return false;
+    }
 };
 
 class karatsuba {
@@ -447,93 +1176,48 @@ public:
     -> int_type
     {
         constexpr int mi = std::min(DestLen, SrcLen);
-        int_type cr = 0;
-        auto i = 0;
-        for(i = 0; i < mi; ++i) {
-            dest[i] += cr;
-            cr = (dest[i] < cr);
-            dest[i] += src[i];
-            cr |= (dest[i] < src[i]);
-        }
-        for(; i < DestLen && cr; ++i) {
-            dest[i] += cr;
-            cr = !dest[i];
+        if constexpr (mi <= 0) return 0;
+        else {
+            const auto cr = impl_base::add_n(dest, src, mi);
+            return impl_base::carry_n(dest + mi, DestLen - mi, cr);
         }
-        return cr;
     }
     template<int DestLen>
     static constexpr auto add(int_type* dest, int_type src) noexcept
     -> int_type
     {
-        int_type cr = 0;
-        auto i = 0;
-        dest[i] += src;
-        cr = (dest[i] < src);
-        for(; i < DestLen && cr; ++i) {
-            dest[i] += cr;
-            cr = !dest[i];
+        if constexpr (DestLen <= 0) return 0;
+        else {
+            const auto cr = impl_base::addc(0, dest[0], src, dest[0]);
+            return impl_base::carry_n(dest + 1, DestLen - 1, cr);
         }
-        return cr;
     }
+    /// @return 借りが発生すれば~0，しなければ0
     template<int DestLen, int SrcLen>
     static constexpr auto sub(int_type* dest, const int_type* src) noexcept
     -> int_type
     {
         constexpr int mi = std::min(DestLen, SrcLen);
-        int_type cr = 1;
-        int i;
-        for(i = 0; i < mi; ++i) {
-            dest[i] += cr;
-            cr = (dest[i] < cr);
-            dest[i] += ~src[i];
-            cr |= (dest[i] < ~src[i]);
-        }
-        for(; i < DestLen && !cr; ++i) {
-            dest[i] += cr;
-            cr = (dest[i] < cr);
-            dest[i] += ~(int_type)0;
-            cr |= (dest[i] < ~(int_type)0);
-        }
-        return cr + ~(int_type)0;
+        if constexpr (mi <= 0) return 0;
+        else {
+            const auto br = impl_base::sub_n(dest, src, mi);
+            return (int_type)0 - impl_base::borrow_n(dest + mi, DestLen - mi, br);
+        }
     }
+    /// @brief dest = |dest - src|
+    /// @return dest < srcならtrue
     template<int DestLen, int SrcLen>
     static constexpr auto diff(int_type* dest, const int_type* src) noexcept
     -> bool
     {
-        if(sub<DestLen, SrcLen>(dest, src) >> 31) {
-            int_type cr = 1;
+        if(sub<DestLen, SrcLen>(dest, src)) {
+            unsigned char cr = 1;
             for(int i = 0; i < DestLen; ++i) {
-                dest[i] = ~dest[i];
-                dest[i] += cr;
-                cr = dest[i] < cr;
+                cr = impl_base::addc(cr, ~dest[i], 0, dest[i]);
             }
             return true;
         }
         return false;
-        // auto cmp = impl_base::cmp<sign::mp_unsigned, DestLen, SrcLen>(dest, src);
-        // if(cmp == 1) {
-        //     sub<DestLen, SrcLen>(dest, src);
-        // } else if(cmp == 0) {
-        //     std::fill_n(dest, DestLen, (int_type)0);
-        // } else {
-        //     constexpr int mi = std::min(DestLen, SrcLen);
-        //     int_type cr = 1;
-        //     int i;
-        //     for(i = 0; i < mi; ++i) {
-        //         dest[i] = ~dest[i];
-        //         dest[i] += cr;
-        //         cr = (dest[i] < cr);
-        //         dest[i] += src[i];
-        //         cr |= (dest[i] < ~src[i]);
-        //     }
-        //     for(; i < DestLen; ++i) {
-        //         dest[i] = ~dest[i];
-        //         dest[i] += cr;
-        //         cr = (dest[i] < cr);
-        //     }
-        //     return true;
-        // }
-        // return false;
     }
 
     template<int DestLen, int SrcLen>
@@ -584,19 +1268,143 @@ public:
         }
     }
 
+    /// @brief out[0, max(lx, ly)) = |x - y|．lx, lyは高々1だけ異なる
+    /// @return x < yならtrue
+    static constexpr bool abs_diff(int_type* out, const int_type* x, unsigned int lx, const int_type* y, unsigned int ly) noexcept
+    {
+        const auto n = std::max(lx, ly);
+        auto get = [](const int_type* p, unsigned int l, unsigned int i) { return i < l ? p[i] : (int_type)0; };
+        bool x_less = false;
+        for (auto i = n; i-- > 0;) {
+            const auto xi = get(x, lx, i), yi = get(y, ly, i);
+            if (xi != yi) {
+                x_less = xi < yi;
+                break;
+            }
+        }
+        if (x_less) {
+            std::swap(x, y);
+            std::swap(lx, ly);
+        }
+        unsigned char br = 0;
+        for (auto i = 0u; i < n; ++i) br = impl_base::subb(br, get(x, lx, i), get(y, ly, i), out[i]);
+        return x_less;
+    }
+    /// @brief kmul_nが必要とする作業領域の桁数
+    static constexpr unsigned int kmul_n_scratch(unsigned int n) noexcept { return 8 * n + 64; }
+    /// @brief dest[0, 2n) = a[0, n) * b[0, n)．長さを実行時に与えるkaratsuba法．
+    static constexpr void kmul_n(int_type* dest, const int_type* a, const int_type* b, unsigned int n, int_type* scratch) noexcept
+    {
+        if (n < 2 * karatsuba_threashold) {
+            naive_mul::mul_n(dest, 2 * n, a, n, b, n);
+            return;
+        }
+        const unsigned int h = n / 2, hh = n - h;
+        kmul_n(dest, a, b, h, scratch);
+        kmul_n(dest + 2 * h, a + h, b + h, hh, scratch);
+        // z1 = |a0 - a1| * |b1 - b0|
+        int_type* t1 = scratch;
+        int_type* t2 = scratch + hh;
+        int_type* z1 = scratch + 2 * hh;
+        int_type* m = scratch + 4 * hh;
+        const bool neg = abs_diff(t1, a, h, a + h, hh) ^ abs_diff(t2, b + h, hh, b, h);
+        kmul_n(z1, t1, t2, hh, m);
+        // m = z0 + z2 ± z1
+        std::copy(dest + 2 * h, dest + 2 * n, m);
+        m[2 * hh] = impl_base::carry_n(m + 2 * h, 2 * hh - 2 * h, impl_base::add_n(m, dest, 2 * h));
+        if (neg) m[2 * hh] -= impl_base::sub_n(m, z1, 2 * hh);
+        else m[2 * hh] += impl_base::add_n(m, z1, 2 * hh);
+        // 2n - h >= 2hh + 1
+        const auto c = impl_base::add_n(dest + h, m, 2 * hh + 1);
+        impl_base::carry_n(dest + h + 2 * hh + 1, 2 * n - h - 2 * hh - 1, c);
+    }
+    static constexpr unsigned int mul_n_scratch(unsigned int la, unsigned int lb) noexcept
+    {
+        const auto n = std::min(la, lb);
+        return kmul_n_scratch(n) + 2 * n;
+    }
+    /// @brief dest[0, la+lb) = a[0, la) * b[0, lb)．長さを実行時に与える．
+    /// 短い方が閾値を超えるときは短い方の長さで区切ってkmul_nを繰り返す．scratchにはmul_n_scratch(la, lb)桁必要．
+    static constexpr void mul_n(int_type* dest, const int_type* a, unsigned int la, const int_type* b, unsigned int lb, int_type* scratch) noexcept
+    {
+        if (la < lb) {
+            std::swap(a, b);
+            std::swap(la, lb);
+        }
+        if (lb < 2 * karatsuba_threashold) {
+            naive_mul::mul_n(dest, la + lb, a, la, b, lb);
+            return;
+        }
+        std::fill_n(dest, la + lb, (int_type)0);
+        int_type* t = scratch;
+        for (auto off = 0u; off < la; off += lb) {
+            const auto len = std::min(lb, la - off);
+            if (len == lb) kmul_n(t, a + off, b, lb, scratch + 2 * lb);
+            else naive_mul::mul_n(t, len + lb, b, lb, a + off, len);
+            const auto c = impl_base::add_n(dest + off, t, len + lb);
+            impl_base::carry_n(dest + off + len + lb, la + lb - off - len - lb, c);
+        }
+    }
+
+    /// @brief 有効な桁数activeが収まる最小の長さでkmulを呼ぶ
+    template<int DestLen, int SrcLen>
+    static inline void kmul_active(int_type* dest, const int_type* a, const int_type* b, unsigned int active) noexcept
+    {
+        if constexpr (SrcLen % 2 == 0 && SrcLen / 2 > karatsuba_threashold) {
+            if (active <= SrcLen / 2) {
+                kmul_active<DestLen, SrcLen / 2>(dest, a, b, active);
+                return;
+            }
+        }
+        kmul<DestLen, SrcLen>(dest, a, b);
+    }
+
     template<unsigned int BitWidthD, unsigned int BitWidth1, unsigned int BitWidth2>
     static constexpr auto mul(int_representation<BitWidthD>& dest, const int_representation<BitWidth1>& a, const int_representation<BitWidth2>& b) noexcept
     -> std::enable_if_t<(BitWidth1 > 0) && (BitWidth2 > 0)>
     {
-        typedef typename int_representation<BitWidthD>::coeff_type int_type;
-        constexpr auto Len1 = BitWidth1 / 8 / sizeof(int_type);
-        dest.flush();
+        constexpr auto Len1 = int_representation<BitWidth1>::length;
+#if defined(CHAO_HAS_INT128)
+        if constexpr (BitWidthD == 128 && BitWidth1 == 128 && BitWidth2 == 128) {
+            from_native(dest, to_native(a) * to_native(b));
+            return;
+        }
+#endif
         if (std::is_constant_evaluated()) {
+            dest.flush();
             naive_mul::mul(dest, a, b);
-        } else if constexpr (BitWidth1 == BitWidth2 && ((Len1 >> std::countr_zero(Len1)) <= karatsuba_threashold)) {
-            karatsuba::kmul<BitWidthD / 8 / sizeof(int_type), Len1>(dest.poly.data(), a.poly.data(), b.poly.data());
-        } else{
-            naive_mul::mul(dest, a, b);
+            return;
+        }
+        mul_limbs<int_representation<BitWidthD>::length, Len1, int_representation<BitWidth2>::length>(dest.poly.data(), a.poly.data(), b.poly.data());
+    }
+    /// @brief dest[0, DestLen) = a[0, Len1) * b[0, Len2)の下位DestLen桁．destはa, bと重なってはならない．
+    template<unsigned int DestLen, unsigned int Len1, unsigned int Len2>
+    static constexpr void mul_limbs(int_type* dest, const int_type* a, const int_type* b) noexcept
+    {
+#if defined(CHAO_HAS_INT128)
+        if constexpr (DestLen == 2 && Len1 == 2 && Len2 == 2) {
+            const native_uint128 r = ((native_uint128)a[1] << 64 | a[0]) * ((native_uint128)b[1] << 64 | b[0]);
+            dest[0] = (int_type)r;
+            dest[1] = (int_type)(r >> 64);
+            return;
+        }
+#endif
+        if (std::is_constant_evaluated()) {
+            naive_mul::mul_n(dest, DestLen, a, Len1, b, Len2);
+        } else if constexpr (Len1 <= impl_base::unroll_limit && Len1 == Len2) {
+            std::fill_n(dest, DestLen, (int_type)0);
+            karatsuba::kmul<DestLen, Len1>(dest, a, b);
+        } else {
+            // 宣言された幅ではなく実際の桁数で計算方法を選ぶ
+            const auto la = impl_base::active_length(a, Len1), lb = impl_base::active_length(b, Len2);
+            if constexpr (Len1 == Len2 && ((Len1 >> std::countr_zero(Len1)) <= karatsuba_threashold)) {
+                if (std::min(la, lb) > (unsigned int)karatsuba_threashold) {
+                    std::fill_n(dest, DestLen, (int_type)0);
+                    karatsuba::kmul_active<DestLen, Len1>(dest, a, b, std::max(la, lb));
+                    return;
+                }
+            }
+            naive_mul::mul_n(dest, DestLen, a, la, b, lb);
         }
     }
 
@@ -0,0 +1,689 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cassert>
+#include <compare>
+#include <concepts>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "detail/common.hpp"
+#include "detail/opimpl.hpp"
+#include "mp_int.hpp"
+#include "convertion.hpp"
+
+namespace chao {
+
+template<class Allocator>
+class basic_dynamic_mp_int;
+
+namespace detail {
+
+struct dynamic_expression_base {};
+
+template<class T>
+struct is_basic_dynamic_mp_int : std::false_type {};
+template<class A>
+struct is_basic_dynamic_mp_int<basic_dynamic_mp_int<A>> : std::true_type {};
+
+template<class T>
+concept dynamic_integer = is_basic_dynamic_mp_int<std::remove_cvref_t<T>>::value;
+
+template<class T>
+concept dynamic_expression = std::is_base_of_v<dynamic_expression_base, std::remove_cvref_t<T>>;
+
+template<class T>
+concept dynamic_operand = dynamic_integer<T>
+    || dynamic_expression<T>
+    || (std::integral<std::remove_cvref_t<T>> && !std::is_same_v<std::remove_cvref_t<T>, bool>);
+
+/// @brief 被演算子を評価した結果の型．組み込み整数ならvoid．
+template<class T>
+struct dynamic_value { using type = void; };
+template<dynamic_integer T>
+struct dynamic_value<T> { using type = std::remove_cvref_t<T>; };
+template<dynamic_expression T>
+struct dynamic_value<T> { using type = typename std::remove_cvref_t<T>::value_type; };
+template<class T>
+using dynamic_value_t = typename dynamic_value<T>::type;
+
+template<class L, class R>
+using dynamic_common_t = std::conditional_t<std::is_void_v<dynamic_value_t<L>>, dynamic_value_t<R>, dynamic_value_t<L>>;
+
+template<class L, class R>
+concept dynamic_binary_operands = dynamic_operand<L> && dynamic_operand<R>
+    && !(std::integral<std::remove_cvref_t<L>> && std::integral<std::remove_cvref_t<R>>)
+    && (std::is_void_v<dynamic_value_t<L>> || std::is_void_v<dynamic_value_t<R>> || std::is_same_v<dynamic_value_t<L>, dynamic_value_t<R>>);
+
+}
+
+/// @brief 実行時に桁数が決まる符号付き多倍長整数．
+/// 無限に符号拡張された2の補数として表し，値を表すのに必要な最小の桁数だけを保持する．
+/// small_length桁以下の値はオブジェクト内のバッファに置き，ヒープを確保しない．
+/// 計算はmp_intと同じimpl_base, naive_mul, karatsubaの(ポインタ, 長さ)版の関数で行う．
+/// 桁のバッファはAllocatorで確保する．std::pmr::polymorphic_allocatorを与えれば
+/// chao::pmr::limb_arenaやchao::pmr::limb_poolから確保できる．
+/// 演算の一時オブジェクトや作業領域は結果の代入先と同じアロケータで確保する．
+template<class Allocator>
+class basic_dynamic_mp_int {
+    using alloc_traits = std::allocator_traits<Allocator>;
+public:
+    using int_type = detail::impl_base::int_type;
+    using allocator_type = Allocator;
+    static constexpr unsigned int small_length = 4;
+    static_assert(std::is_same_v<typename alloc_traits::value_type, int_type>);
+
+    basic_dynamic_mp_int() noexcept(noexcept(Allocator()))
+        : basic_dynamic_mp_int(Allocator())
+    {}
+    explicit basic_dynamic_mp_int(const Allocator& alloc) noexcept
+        : alloc_(alloc)
+        , data_(local_)
+        , size_(0)
+        , capacity_(small_length)
+    {}
+    template<std::integral T>
+    basic_dynamic_mp_int(T i, const Allocator& alloc = Allocator()) noexcept
+        : basic_dynamic_mp_int(alloc)
+    {
+        *this = i;
+    }
+    template<sign Sign, unsigned int BitWidth>
+    basic_dynamic_mp_int(const mp_int<Sign, BitWidth>& v, const Allocator& alloc = Allocator())
+        : basic_dynamic_mp_int(alloc)
+    {
+        constexpr unsigned int len = mp_int<Sign, BitWidth>::length;
+        // 符号なしの値は最上位ビットが立っていても正なので1桁余分に持つ
+        constexpr unsigned int n = len + (Sign == sign::mp_unsigned);
+        reserve(n);
+        std::copy(v.value_.poly.begin(), v.value_.poly.end(), data_);
+        if constexpr (Sign == sign::mp_unsigned) data_[len] = 0;
+        size_ = n;
+        normalize();
+    }
+    template<detail::derived_expression E>
+    explicit basic_dynamic_mp_int(const E& e, const Allocator& alloc = Allocator())
+        : basic_dynamic_mp_int(expr_to_mp_int(e), alloc)
+    {}
+    template<detail::dynamic_expression E>
+    basic_dynamic_mp_int(const E& e)
+        : basic_dynamic_mp_int(e.get_allocator())
+    {
+        e.evaluate(*this);
+    }
+    template<detail::dynamic_expression E>
+    basic_dynamic_mp_int(const E& e, const Allocator& alloc)
+        : basic_dynamic_mp_int(alloc)
+    {
+        e.evaluate(*this);
+    }
+    /// @brief 文字列から構築する．baseが0のときは接頭辞(0x, 0b, 0)から判定する．
+    explicit basic_dynamic_mp_int(std::string_view str, int base = 10, const Allocator& alloc = Allocator())
+        : basic_dynamic_mp_int(alloc)
+    {
+        if(str.empty()) throw std::invalid_argument("string must have length longer than 0.");
+        const bool is_negative = str.front() == '-';
+        str = str.substr(is_negative);
+        if(base == 0) {
+            base = detail::detect_base(str);
+            str = str.substr(base == 16 || base == 2 ? 2 : 0);
+        }
+        if(str.empty() || detail::digit(str.front(), base) < 0) throw std::invalid_argument("can't convert into dynamic_mp_int from string.");
+        // 数字1つは高々bit_width(base - 1)ビットなので，1ビット余らせて符号ビットを0に保つ．
+        // 長い10進数字列の作業領域もこのオブジェクトのアロケータで確保する．
+        const std::size_t n = detail::count_digits(str, base);
+        const auto len = (unsigned int)(n * std::bit_width((unsigned int)base - 1) / 64 + 1);
+        reserve(len);
+        std::fill(data_, data_ + len, 0);
+        size_ = len;
+        detail::parse_digits(data_, len, str.data(), n, base, alloc_);
+        normalize();
+        if(is_negative) negate(*this, *this);
+    }
+    basic_dynamic_mp_int(const basic_dynamic_mp_int& other)
+        : basic_dynamic_mp_int(other, alloc_traits::select_on_container_copy_construction(other.alloc_))
+    {}
+    basic_dynamic_mp_int(const basic_dynamic_mp_int& other, const Allocator& alloc)
+        : basic_dynamic_mp_int(alloc)
+    {
+        assign(other);
+    }
+    basic_dynamic_mp_int(basic_dynamic_mp_int&& other) noexcept
+        : basic_dynamic_mp_int(other.alloc_)
+    {
+        steal(other);
+    }
+    ~basic_dynamic_mp_int() {
+        release();
+    }
+
+    basic_dynamic_mp_int& operator=(const basic_dynamic_mp_int& other) & {
+        if(this == &other) return *this;
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+            if(alloc_ != other.alloc_) {
+                release();
+                alloc_ = other.alloc_;
+            }
+        }
+        assign(other);
+        return *this;
+    }
+    basic_dynamic_mp_int& operator=(basic_dynamic_mp_int&& other) & {
+        if(this == &other) return *this;
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+            release();
+            alloc_ = other.alloc_;
+            steal(other);
+        } else if(alloc_ == other.alloc_) {
+            release();
+            steal(other);
+        } else {
+            // 別のアロケータで確保された桁は受け取れないので写す
+            assign(other);
+        }
+        return *this;
+    }
+    template<std::integral T>
+    basic_dynamic_mp_int& operator=(T i) & noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            data_[0] = (int_type)(std::int64_t)i;
+            size_ = 1;
+        } else {
+            data_[0] = (int_type)i;
+            data_[1] = 0;
+            size_ = 2;
+        }
+        normalize();
+        return *this;
+    }
+    template<detail::dynamic_expression E>
+    basic_dynamic_mp_int& operator=(const E& e) & {
+        e.evaluate(*this);
+        return *this;
+    }
+
+    template<detail::dynamic_operand E>
+    basic_dynamic_mp_int& operator+=(const E& e) & { add(*this, *this, operand(e)); return *this; }
+    template<detail::dynamic_operand E>
+    basic_dynamic_mp_int& operator-=(const E& e) & { sub(*this, *this, operand(e)); return *this; }
+    template<detail::dynamic_operand E>
+    basic_dynamic_mp_int& operator*=(const E& e) & { mul(*this, *this, operand(e)); return *this; }
+    template<detail::dynamic_operand E>
+    basic_dynamic_mp_int& operator/=(const E& e) & { divmod(this, nullptr, *this, operand(e)); return *this; }
+    template<detail::dynamic_operand E>
+    basic_dynamic_mp_int& operator%=(const E& e) & { divmod(nullptr, this, *this, operand(e)); return *this; }
+    template<detail::dynamic_operand E>
+    basic_dynamic_mp_int& operator&=(const E& e) & { bitwise<std::bit_and<>>(*this, *this, operand(e)); return *this; }
+    template<detail::dynamic_operand E>
+    basic_dynamic_mp_int& operator|=(const E& e) & { bitwise<std::bit_or<>>(*this, *this, operand(e)); return *this; }
+    template<detail::dynamic_operand E>
+    basic_dynamic_mp_int& operator^=(const E& e) & { bitwise<std::bit_xor<>>(*this, *this, operand(e)); return *this; }
+    basic_dynamic_mp_int& operator<<=(unsigned int w) & { shiftl(*this, *this, w); return *this; }
+    basic_dynamic_mp_int& operator>>=(unsigned int w) & { shiftr(*this, *this, w); return *this; }
+
+    basic_dynamic_mp_int& operator++() & { return *this += 1; }
+    basic_dynamic_mp_int& operator--() & { return *this -= 1; }
+    basic_dynamic_mp_int operator++(int) & {
+        basic_dynamic_mp_int cp(*this, alloc_);
+        *this += 1;
+        return cp;
+    }
+    basic_dynamic_mp_int operator--(int) & {
+        basic_dynamic_mp_int cp(*this, alloc_);
+        *this -= 1;
+        return cp;
+    }
+    [[nodiscard]]
+    const basic_dynamic_mp_int& operator+() const noexcept { return *this; }
+    [[nodiscard]]
+    basic_dynamic_mp_int operator-() const {
+        basic_dynamic_mp_int r(alloc_);
+        negate(r, *this);
+        return r;
+    }
+    [[nodiscard]]
+    basic_dynamic_mp_int operator~() const {
+        basic_dynamic_mp_int r(*this, alloc_);
+        for(auto i = 0u; i < r.size_; ++i) r.data_[i] = ~r.data_[i];
+        if(!r.size_) r = -1;
+        return r;
+    }
+
+    [[nodiscard]]
+    std::strong_ordering operator<=>(const basic_dynamic_mp_int& o) const noexcept {
+        const int r = cmp(*this, o);
+        return r == 0 ? std::strong_ordering::equal
+            : r > 0 ? std::strong_ordering::greater
+            : std::strong_ordering::less;
+    }
+    [[nodiscard]]
+    bool operator==(const basic_dynamic_mp_int& o) const noexcept {
+        return size_ == o.size_ && std::equal(data_, data_ + size_, o.data_);
+    }
+
+    [[nodiscard]]
+    explicit operator bool() const noexcept { return size_ != 0; }
+    [[nodiscard]]
+    bool operator!() const noexcept { return size_ == 0; }
+    template<std::integral T>
+    [[nodiscard]]
+    explicit operator T() const noexcept { return static_cast<T>(limb(0)); }
+    /// @brief 下位BitWidthビットを取り出す
+    template<sign Sign, unsigned int BitWidth>
+    [[nodiscard]]
+    explicit operator mp_int<Sign, BitWidth>() const noexcept {
+        mp_int<Sign, BitWidth> r;
+        for(auto i = 0u; i < r.length; ++i) r.value_.poly[i] = limb(i);
+        return r;
+    }
+
+    void evaluate(basic_dynamic_mp_int& dest) const {
+        dest = *this;
+    }
+    [[nodiscard]]
+    const basic_dynamic_mp_int& evaluate() const noexcept { return *this; }
+
+    /// @brief 値を表すのに使っている桁数
+    [[nodiscard]]
+    unsigned int size() const noexcept { return size_; }
+    [[nodiscard]]
+    unsigned int capacity() const noexcept { return capacity_; }
+    [[nodiscard]]
+    allocator_type get_allocator() const noexcept { return alloc_; }
+    [[nodiscard]]
+    const int_type* data() const noexcept { return data_; }
+    [[nodiscard]]
+    int_type* data() noexcept { return data_; }
+    [[nodiscard]]
+    bool is_negative() const noexcept { return size_ && (data_[size_ - 1] >> 63); }
+    /// @brief 符号拡張込みでi桁目を返す
+    [[nodiscard]]
+    int_type limb(unsigned int i) const noexcept { return i < size_ ? data_[i] : fill(); }
+    void reserve(unsigned int n) {
+        if(n <= capacity_) return;
+        // 2の冪に揃えてプールのサイズクラスに乗せる
+        const unsigned int cap = std::max(std::bit_ceil(n), capacity_ * 2);
+        int_type* p = alloc_traits::allocate(alloc_, cap);
+        std::copy(data_, data_ + size_, p);
+        release();
+        data_ = p;
+        capacity_ = cap;
+    }
+
+    /// @brief dest = a + b
+    static void add(basic_dynamic_mp_int& dest, const basic_dynamic_mp_int& a, const basic_dynamic_mp_int& b) {
+        if(&dest == &b && &dest != &a) return add(dest, b, a);
+        const unsigned int sb = b.size_;
+        const int_type fb = b.fill();
+        if(&dest != &a) dest.assign(a);
+        const unsigned int n = std::max(dest.size_, sb) + 1;
+        dest.resize(n);
+        unsigned char c = detail::impl_base::add_n(dest.data_, b.data_, sb);
+        for(auto i = sb; i < n; ++i) c = detail::impl_base::addc(c, dest.data_[i], fb, dest.data_[i]);
+        dest.normalize();
+    }
+    /// @brief dest = a - b
+    static void sub(basic_dynamic_mp_int& dest, const basic_dynamic_mp_int& a, const basic_dynamic_mp_int& b) {
+        if(&dest == &b && &dest != &a) {
+            const basic_dynamic_mp_int t(b, dest.alloc_);
+            return sub(dest, a, t);
+        }
+        const unsigned int sb = b.size_;
+        const int_type fb = b.fill();
+        if(&dest != &a) dest.assign(a);
+        const unsigned int n = std::max(dest.size_, sb) + 1;
+        dest.resize(n);
+        unsigned char c = detail::impl_base::sub_n(dest.data_, b.data_, sb);
+        for(auto i = sb; i < n; ++i) c = detail::impl_base::subb(c, dest.data_[i], fb, dest.data_[i]);
+        dest.normalize();
+    }
+    /// @brief dest = -a
+    static void negate(basic_dynamic_mp_int& dest, const basic_dynamic_mp_int& a) {
+        if(&dest != &a) dest.assign(a);
+        dest.resize(dest.size_ + 1);
+        unsigned char br = 0;
+        for(auto i = 0u; i < dest.size_; ++i) br = detail::impl_base::subb(br, 0, dest.data_[i], dest.data_[i]);
+        dest.normalize();
+    }
+    /// @brief dest = a * b
+    static void mul(basic_dynamic_mp_int& dest, const basic_dynamic_mp_int& a, const basic_dynamic_mp_int& b) {
+        const bool negative = a.is_negative() != b.is_negative();
+        basic_dynamic_mp_int abs_a(dest.alloc_), abs_b(dest.alloc_);
+        const basic_dynamic_mp_int* ma = &a;
+        const basic_dynamic_mp_int* mb = &b;
+        if(a.is_negative()) {
+            negate(abs_a, a);
+            ma = &abs_a;
+        }
+        if(b.is_negative()) {
+            negate(abs_b, b);
+            mb = &abs_b;
+        }
+        const auto la = detail::impl_base::active_length(ma->data_, ma->size_);
+        const auto lb = detail::impl_base::active_length(mb->data_, mb->size_);
+        basic_dynamic_mp_int r(dest.alloc_);
+        r.reserve(la + lb + 1);
+        if(std::min(la, lb) < 2 * detail::karatsuba::karatsuba_threashold) {
+            detail::naive_mul::mul_n(r.data_, la + lb, ma->data_, la, mb->data_, lb);
+        } else {
+            basic_dynamic_mp_int scratch(dest.alloc_);
+            scratch.reserve(detail::karatsuba::mul_n_scratch(la, lb));
+            detail::karatsuba::mul_n(r.data_, ma->data_, la, mb->data_, lb, scratch.data_);
+        }
+        r.data_[la + lb] = 0;
+        r.size_ = la + lb + 1;
+        if(negative) negate(r, r);
+        r.normalize();
+        dest = std::move(r);
+    }
+    /// @brief *quotient = a / b, *remainder = a % b．0方向への切り捨て除算．bは0であってはならない．
+    static void divmod(basic_dynamic_mp_int* quotient, basic_dynamic_mp_int* remainder, const basic_dynamic_mp_int& a, const basic_dynamic_mp_int& b) {
+        assert(b.size_ != 0);
+        const bool na = a.is_negative(), nb = b.is_negative();
+        const Allocator& alloc = quotient ? quotient->alloc_ : remainder ? remainder->alloc_ : a.alloc_;
+        basic_dynamic_mp_int abs_a(alloc), abs_b(alloc);
+        const basic_dynamic_mp_int* ma = &a;
+        const basic_dynamic_mp_int* mb = &b;
+        if(na) {
+            negate(abs_a, a);
+            ma = &abs_a;
+        }
+        if(nb) {
+            negate(abs_b, b);
+            mb = &abs_b;
+        }
+        const auto la = detail::impl_base::active_length(ma->data_, ma->size_);
+        const auto lb = detail::impl_base::active_length(mb->data_, mb->size_);
+        basic_dynamic_mp_int q(alloc), r(alloc);
+        if(la < lb) {
+            r = *ma;
+        } else {
+            q.reserve(la - lb + 2);
+            r.reserve(lb + 1);
+            basic_dynamic_mp_int scratch(alloc);
+            scratch.reserve(detail::naive_mul::div_n_scratch(la, lb));
+            detail::naive_mul::div_n(q.data_, r.data_, ma->data_, la, mb->data_, lb, scratch.data_);
+            q.data_[la - lb + 1] = 0;
+            q.size_ = la - lb + 2;
+            r.data_[lb] = 0;
+            r.size_ = lb + 1;
+            q.normalize();
+            r.normalize();
+        }
+        if(quotient) {
+            if(na != nb) negate(q, q);
+            *quotient = std::move(q);
+        }
+        if(remainder) {
+            if(na) negate(r, r);
+            *remainder = std::move(r);
+        }
+    }
+    /// @brief dest = a op b (op = std::bit_and<>, std::bit_or<>, std::bit_xor<>)
+    template<class Op>
+    static void bitwise(basic_dynamic_mp_int& dest, const basic_dynamic_mp_int& a, const basic_dynamic_mp_int& b) {
+        if(&dest == &b && &dest != &a) return bitwise<Op>(dest, b, a);
+        if(&dest != &a) dest.assign(a);
+        const unsigned int n = std::max(dest.size_, b.size_);
+        dest.resize(n);
+        for(auto i = 0u; i < n; ++i) dest.data_[i] = Op{}(dest.data_[i], b.limb(i));
+        dest.normalize();
+    }
+    /// @brief dest = a << w
+    static void shiftl(basic_dynamic_mp_int& dest, const basic_dynamic_mp_int& a, unsigned int w) {
+        if(&dest != &a) dest.assign(a);
+        if(!dest.size_) return;
+        const unsigned int n = dest.size_ + w / 64 + 1;
+        dest.resize(n);
+        detail::bitop::shiftl_n(dest.data_, n, w);
+        dest.normalize();
+    }
+    /// @brief dest = a >> w．負の値は負の無限大方向に丸める．
+    static void shiftr(basic_dynamic_mp_int& dest, const basic_dynamic_mp_int& a, unsigned int w) {
+        if(&dest != &a) dest.assign(a);
+        if(!dest.size_) return;
+        detail::bitop::shiftr_n(dest.data_, dest.size_, w, dest.fill());
+        dest.normalize();
+    }
+    /// @return a < bなら負，a == bなら0，a > bなら正
+    static int cmp(const basic_dynamic_mp_int& a, const basic_dynamic_mp_int& b) noexcept {
+        const bool na = a.is_negative(), nb = b.is_negative();
+        if(na != nb) return na ? -1 : 1;
+        // 正規化されているので，符号が同じなら桁数の多い方が絶対値が大きい
+        if(a.size_ != b.size_) return (a.size_ > b.size_) != na ? 1 : -1;
+        for(auto i = a.size_; i-- > 0;) {
+            if(a.data_[i] != b.data_[i]) return a.data_[i] > b.data_[i] ? 1 : -1;
+        }
+        return 0;
+    }
+
+private:
+    [[no_unique_address]] Allocator alloc_;
+    int_type* data_;
+    unsigned int size_;
+    unsigned int capacity_;
+    int_type local_[small_length];
+
+    /// @brief 複合代入の右辺をこのオブジェクトと同じアロケータで評価する
+    template<class E>
+    decltype(auto) operand(const E& e) const {
+        if constexpr (std::is_same_v<std::remove_cvref_t<E>, basic_dynamic_mp_int>) return (e);
+        else return basic_dynamic_mp_int(e, alloc_);
+    }
+
+    int_type fill() const noexcept { return is_negative() ? ~(int_type)0 : 0; }
+    /// @brief 桁数をnにする．増えた桁は符号拡張する．
+    void resize(unsigned int n) {
+        const int_type f = fill();
+        reserve(n);
+        std::fill(data_ + std::min(size_, n), data_ + n, f);
+        size_ = n;
+    }
+    /// @brief 符号拡張で復元できる上位の桁を取り除く
+    void normalize() noexcept {
+        while(size_) {
+            const int_type t = data_[size_ - 1];
+            if(size_ == 1) {
+                if(t == 0) --size_;
+                break;
+            }
+            const bool below = data_[size_ - 2] >> 63;
+            if((t == 0 && !below) || (t == ~(int_type)0 && below)) --size_;
+            else break;
+        }
+    }
+    void assign(const basic_dynamic_mp_int& other) {
+        size_ = 0;
+        reserve(other.size_);
+        std::copy(other.data_, other.data_ + other.size_, data_);
+        size_ = other.size_;
+    }
+    /// @brief otherの中身を受け取る．thisは空でなければならない．
+    void steal(basic_dynamic_mp_int& other) noexcept {
+        if(other.data_ == other.local_) {
+            std::copy(other.local_, other.local_ + other.size_, local_);
+            data_ = local_;
+            capacity_ = small_length;
+        } else {
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            other.data_ = other.local_;
+            other.capacity_ = small_length;
+        }
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+    void release() noexcept {
+        if(data_ != local_) alloc_traits::deallocate(alloc_, data_, capacity_);
+        data_ = local_;
+        capacity_ = small_length;
+    }
+};
+
+typedef basic_dynamic_mp_int<std::allocator<std::uint64_t>> dynamic_mp_int;
+
+namespace pmr {
+typedef basic_dynamic_mp_int<std::pmr::polymorphic_allocator<std::uint64_t>> dynamic_mp_int;
+}
+
+namespace detail {
+
+struct dynamic_add_op { template<class D> void operator()(D& d, const D& a, const D& b) const { D::add(d, a, b); } };
+struct dynamic_sub_op { template<class D> void operator()(D& d, const D& a, const D& b) const { D::sub(d, a, b); } };
+struct dynamic_mul_op { template<class D> void operator()(D& d, const D& a, const D& b) const { D::mul(d, a, b); } };
+struct dynamic_div_op { template<class D> void operator()(D& d, const D& a, const D& b) const { D::divmod(&d, nullptr, a, b); } };
+struct dynamic_mod_op { template<class D> void operator()(D& d, const D& a, const D& b) const { D::divmod(nullptr, &d, a, b); } };
+template<class Op>
+struct dynamic_bitwise_op { template<class D> void operator()(D& d, const D& a, const D& b) const { D::template bitwise<Op>(d, a, b); } };
+
+/// @brief basic_dynamic_mp_intの二項演算の式．評価するときは結果を代入先に直接書き込む．
+/// 組み込み整数の被演算子や部分式は代入先のアロケータで評価する．
+template<class Op, class L, class R>
+class dynamic_expr : public dynamic_expression_base {
+public:
+    using value_type = dynamic_common_t<L, R>;
+private:
+    template<class T>
+    using operand_t = std::conditional_t<std::is_integral_v<T>, T, const T&>;
+    operand_t<L> l_;
+    operand_t<R> r_;
+
+    template<class T>
+    static decltype(auto) to_dynamic(const T& e, const typename value_type::allocator_type& alloc) {
+        if constexpr (std::is_same_v<T, value_type>) return (e);
+        else return value_type(e, alloc);
+    }
+public:
+    dynamic_expr(const L& l, const R& r)
+        : l_(l)
+        , r_(r)
+    {}
+    void evaluate(value_type& dest) const {
+        const auto alloc = dest.get_allocator();
+        Op{}(dest, to_dynamic(l_, alloc), to_dynamic(r_, alloc));
+    }
+    [[nodiscard]]
+    value_type evaluate() const {
+        value_type r(get_allocator());
+        evaluate(r);
+        return r;
+    }
+    /// @brief 最も左にある多倍長整数の被演算子のアロケータ
+    [[nodiscard]]
+    typename value_type::allocator_type get_allocator() const {
+        if constexpr (!std::is_integral_v<L>) return l_.get_allocator();
+        else return r_.get_allocator();
+    }
+    template<sign Sign, unsigned int BitWidth>
+    [[nodiscard]]
+    explicit operator mp_int<Sign, BitWidth>() const {
+        return static_cast<mp_int<Sign, BitWidth>>(evaluate());
+    }
+};
+
+}
+
+template<class L, class R> requires detail::dynamic_binary_operands<L, R>
+[[nodiscard]]
+auto operator+(const L& l, const R& r) { return detail::dynamic_expr<detail::dynamic_add_op, L, R>(l, r); }
+template<class L, class R> requires detail::dynamic_binary_operands<L, R>
+[[nodiscard]]
+auto operator-(const L& l, const R& r) { return detail::dynamic_expr<detail::dynamic_sub_op, L, R>(l, r); }
+template<class L, class R> requires detail::dynamic_binary_operands<L, R>
+[[nodiscard]]
+auto operator*(const L& l, const R& r) { return detail::dynamic_expr<detail::dynamic_mul_op, L, R>(l, r); }
+template<class L, class R> requires detail::dynamic_binary_operands<L, R>
+[[nodiscard]]
+auto operator/(const L& l, const R& r) { return detail::dynamic_expr<detail::dynamic_div_op, L, R>(l, r); }
+template<class L, class R> requires detail::dynamic_binary_operands<L, R>
+[[nodiscard]]
+auto operator%(const L& l, const R& r) { return detail::dynamic_expr<detail::dynamic_mod_op, L, R>(l, r); }
+template<class L, class R> requires detail::dynamic_binary_operands<L, R>
+[[nodiscard]]
+auto operator&(const L& l, const R& r) { return detail::dynamic_expr<detail::dynamic_bitwise_op<std::bit_and<>>, L, R>(l, r); }
+template<class L, class R> requires detail::dynamic_binary_operands<L, R>
+[[nodiscard]]
+auto operator|(const L& l, const R& r) { return detail::dynamic_expr<detail::dynamic_bitwise_op<std::bit_or<>>, L, R>(l, r); }
+template<class L, class R> requires detail::dynamic_binary_operands<L, R>
+[[nodiscard]]
+auto operator^(const L& l, const R& r) { return detail::dynamic_expr<detail::dynamic_bitwise_op<std::bit_xor<>>, L, R>(l, r); }
+
+template<class L, class R> requires detail::dynamic_binary_operands<L, R> && (detail::dynamic_expression<L> || detail::dynamic_expression<R>)
+[[nodiscard]]
+bool operator==(const L& l, const R& r) {
+    using value_type = detail::dynamic_common_t<L, R>;
+    return value_type(l) == value_type(r);
+}
+template<class L, class R> requires detail::dynamic_binary_operands<L, R> && (detail::dynamic_expression<L> || detail::dynamic_expression<R>)
+[[nodiscard]]
+std::strong_ordering operator<=>(const L& l, const R& r) {
+    using value_type = detail::dynamic_common_t<L, R>;
+    return value_type(l) <=> value_type(r);
+}
+
+template<detail::dynamic_operand E> requires (!std::integral<E>)
+[[nodiscard]]
+detail::dynamic_value_t<E> operator<<(const E& e, unsigned int w) {
+    detail::dynamic_value_t<E> r(e, e.get_allocator());
+    r <<= w;
+    return r;
+}
+template<detail::dynamic_operand E> requires (!std::integral<E>)
+[[nodiscard]]
+detail::dynamic_value_t<E> operator>>(const E& e, unsigned int w) {
+    detail::dynamic_value_t<E> r(e, e.get_allocator());
+    r >>= w;
+    return r;
+}
+
+/// @brief nをbase進数で[first, last)に書く．作業用に絶対値の複製をnのアロケータで作る．
+template<class Allocator>
+std::to_chars_result to_chars(char* first, char* last, const basic_dynamic_mp_int<Allocator>& n, int base = 10) {
+    basic_dynamic_mp_int<Allocator> m(n, n.get_allocator());
+    if(n.is_negative()) {
+        if(first == last) return {last, std::errc::value_too_large};
+        *first++ = '-';
+        basic_dynamic_mp_int<Allocator>::negate(m, m);
+    }
+    char* p = detail::write_unsigned(first, last, m.data(), m.size(), base);
+    if(!p) return {last, std::errc::value_too_large};
+    return {p, std::errc{}};
+}
+template<detail::dynamic_expression E>
+std::to_chars_result to_chars(char* first, char* last, const E& e, int base = 10) {
+    return to_chars(first, last, e.evaluate(), base);
+}
+
+/// @brief nを10進数の文字列にする．文字列もnのアロケータ(を文字用にしたもの)で確保する．
+template<class Allocator>
+auto to_string(const basic_dynamic_mp_int<Allocator>& n) {
+    using char_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<char>;
+    std::basic_string<char, std::char_traits<char>, char_allocator> s(detail::max_chars((std::size_t)n.size() * 64, 10) + 1, '\0', char_allocator(n.get_allocator()));
+    s.resize(to_chars(s.data(), s.data() + s.size(), n).ptr - s.data());
+    return s;
+}
+template<detail::dynamic_expression E>
+auto to_string(const E& e) {
+    return to_string(e.evaluate());
+}
+
+template<class Allocator>
+std::ostream& operator<<(std::ostream& os, const basic_dynamic_mp_int<Allocator>& n) {
+    return os << to_string(n);
+}
+template<detail::dynamic_expression E>
+std::ostream& operator<<(std::ostream& os, const E& e) {
+    return os << to_string(e.evaluate());
+}
+
+}
@@ -1,5 +1,8 @@
 #pragma once
 #include <algorithm>
+#include <concepts>
+#include <functional>
+#include <type_traits>
 
 #include "detail/common.hpp"
 #include "detail/opimpl.hpp"
@@ -7,6 +10,213 @@
 
 namespace chao{
 
+namespace detail {
+
+template<class T, class U>
+constexpr bool same_object(const T& t, const U& u) noexcept {
+    return static_cast<const void*>(&t) == static_cast<const void*>(&u);
+}
+
+/// @brief 符号拡張込みでmp_intの桁を読む．fillは構築時に一度だけ計算される．
+struct limb_loader {
+    const impl_base::int_type* p;
+    unsigned int len;
+    impl_base::int_type fill;
+    constexpr impl_base::int_type load(unsigned int i) const noexcept { return p[i]; }
+    constexpr impl_base::int_type load_ext(unsigned int i) const noexcept { return i < len ? p[i] : fill; }
+};
+template<unsigned int Len>
+struct static_limb_loader : limb_loader {
+    static constexpr unsigned int length = Len;
+    static constexpr unsigned int min_length = Len;
+};
+/// @brief ビット演算ではない部分式を一度だけ評価して保持する
+template<sign Sign, unsigned int BW>
+struct owning_limb_loader {
+    static constexpr unsigned int length = mp_int<Sign, BW>::length;
+    static constexpr unsigned int min_length = length;
+    mp_int<Sign, BW> v;
+    impl_base::int_type fill;
+    constexpr impl_base::int_type load(unsigned int i) const noexcept { return v.value_.poly[i]; }
+    constexpr impl_base::int_type load_ext(unsigned int i) const noexcept { return i < length ? v.value_.poly[i] : fill; }
+};
+template<class Op, class L1, class L2>
+struct bitwise_limb_loader {
+    static constexpr unsigned int length = std::max(L1::length, L2::length);
+    static constexpr unsigned int min_length = std::min(L1::min_length, L2::min_length);
+    L1 l1;
+    L2 l2;
+    constexpr impl_base::int_type load(unsigned int i) const noexcept { return Op{}(l1.load(i), l2.load(i)); }
+    constexpr impl_base::int_type load_ext(unsigned int i) const noexcept { return Op{}(l1.load_ext(i), l2.load_ext(i)); }
+};
+
+template<class E>
+concept fused_bitwise_expression = requires(const E& e) { e.limb_loader(); };
+
+template<sign Sign>
+constexpr impl_base::int_type extension_fill(bool msb) noexcept {
+    return (Sign == sign::mp_signed && msb) ? ~(impl_base::int_type)0 : 0;
+}
+
+template<class E>
+constexpr auto make_limb_loader(const E& e) noexcept {
+    using expr_t = std::remove_cvref_t<E>;
+    if constexpr (fused_bitwise_expression<expr_t>) {
+        return e.limb_loader();
+    } else if constexpr (std::is_integral_v<expr_t>) {
+        const auto v = expr_to_mp_int(e);
+        return owning_limb_loader<sign_v<expr_t>, 64>{v, extension_fill<sign_v<expr_t>>(v.value_.msb())};
+    } else if constexpr (std::is_same_v<expr_t, mp_int<expr_t::sign_value, expr_t::bit_length>>) {
+        return static_limb_loader<expr_t::length>{{e.value_.poly.data(), expr_t::length, extension_fill<expr_t::sign_value>(e.value_.msb())}};
+    } else {
+        auto v = e.evaluate();
+        const auto fill = extension_fill<expr_t::sign_value>(v.value_.msb());
+        return owning_limb_loader<expr_t::sign_value, expr_t::bit_length>{v, fill};
+    }
+}
+
+/// @brief ビット演算の式木を全ての葉について1パスで評価し，dest[0, Len)に書く
+template<unsigned int Len, class Loader>
+constexpr void fused_bitwise_evaluate(impl_base::int_type* dest, const Loader& l) noexcept {
+    constexpr unsigned int n = std::min(Len, Loader::min_length);
+    for(auto i = 0u; i < n; ++i) dest[i] = l.load(i);
+    for(auto i = n; i < Len; ++i) dest[i] = l.load_ext(i);
+}
+template<unsigned int Bits, class Loader>
+constexpr void fused_bitwise_evaluate(int_representation<Bits>& dest, const Loader& l) noexcept {
+    fused_bitwise_evaluate<int_representation<Bits>::length>(dest.poly.data(), l);
+}
+
+/// @brief 加減算の式木を1パスで評価するための2桁の桁上がりカウンタ
+struct carry_accumulator {
+    impl_base::int_type lo;
+    impl_base::int_type hi;
+    constexpr void add(impl_base::int_type x) noexcept { hi += impl_base::addc(0, lo, x, lo); }
+    /// @brief 下位桁を取り出し，上位桁を次の桁の初期値にする
+    constexpr impl_base::int_type shift() noexcept {
+        const auto r = lo;
+        lo = hi;
+        hi = 0;
+        return r;
+    }
+};
+/// @brief 加減算の葉．Negateの場合は~xを足し，最下位に1を足すことで-xを表す
+template<bool Negate, class L>
+struct sum_leaf_loader {
+    static constexpr unsigned int length = L::length;
+    static constexpr unsigned int min_length = L::min_length;
+    static constexpr unsigned int carry_in = Negate ? 1 : 0;
+    L l;
+    constexpr void accumulate(unsigned int i, carry_accumulator& acc) const noexcept { acc.add(Negate ? ~l.load(i) : l.load(i)); }
+    constexpr void accumulate_ext(unsigned int i, carry_accumulator& acc) const noexcept { acc.add(Negate ? ~l.load_ext(i) : l.load_ext(i)); }
+};
+template<class L1, class L2>
+struct sum_limb_loader {
+    static constexpr unsigned int length = std::max(L1::length, L2::length);
+    static constexpr unsigned int min_length = std::min(L1::min_length, L2::min_length);
+    static constexpr unsigned int carry_in = L1::carry_in + L2::carry_in;
+    L1 l1;
+    L2 l2;
+    constexpr void accumulate(unsigned int i, carry_accumulator& acc) const noexcept { l1.accumulate(i, acc); l2.accumulate(i, acc); }
+    constexpr void accumulate_ext(unsigned int i, carry_accumulator& acc) const noexcept { l1.accumulate_ext(i, acc); l2.accumulate_ext(i, acc); }
+};
+
+template<class E>
+concept fused_sum_expression = requires(const E& e) { e.template sum_loader<false>(); };
+
+template<bool Negate, class E>
+constexpr auto make_sum_loader(const E& e) noexcept {
+    using expr_t = std::remove_cvref_t<E>;
+    if constexpr (fused_sum_expression<expr_t>) {
+        return e.template sum_loader<Negate>();
+    } else {
+        using l_t = decltype(make_limb_loader(e));
+        return sum_leaf_loader<Negate, l_t>{make_limb_loader(e)};
+    }
+}
+
+/// @brief 加減算の式木を全ての項について1パスで評価し，dest[0, Len)に書く．
+/// 項の数によらず桁上がりは2桁のカウンタに溜めて次の桁へ送る．
+template<unsigned int Len, class Loader>
+constexpr void fused_sum_evaluate(impl_base::int_type* dest, const Loader& l) noexcept {
+    constexpr unsigned int n = std::min(Len, Loader::min_length);
+    carry_accumulator acc{Loader::carry_in, 0};
+    for(auto i = 0u; i < n; ++i) {
+        l.accumulate(i, acc);
+        dest[i] = acc.shift();
+    }
+    for(auto i = n; i < Len; ++i) {
+        l.accumulate_ext(i, acc);
+        dest[i] = acc.shift();
+    }
+}
+template<unsigned int Bits, class Loader>
+constexpr void fused_sum_evaluate(int_representation<Bits>& dest, const Loader& l) noexcept {
+    fused_sum_evaluate<int_representation<Bits>::length>(dest.poly.data(), l);
+}
+
+/// @brief 桁の列を直接持つ式(mp_intとmp_int_view)
+template<class E>
+concept limb_sequence = std::is_base_of_v<expression_base, E> && requires(const E& e) {
+    { e.data() } -> std::convertible_to<const impl_base::int_type*>;
+};
+/// @brief 他のオブジェクトの桁の列を指す被演算子
+template<unsigned int Len>
+struct borrowed_limbs {
+    static constexpr unsigned int length = Len;
+    const impl_base::int_type* p;
+    constexpr const impl_base::int_type* data() const noexcept { return p; }
+};
+/// @brief 評価した値を保持する被演算子
+template<sign Sign, unsigned int BW>
+struct owned_limbs {
+    static constexpr unsigned int length = mp_int<Sign, BW>::length;
+    mp_int<Sign, BW> v;
+    constexpr const impl_base::int_type* data() const noexcept { return v.data(); }
+};
+/// @brief 掛け算や割り算，比較の被演算子eの桁の列．
+/// 桁の列を持つ式は桁数がBitsビット(Bits == 0なら自身の幅)の桁数と同じなら写さずに指す．
+/// それ以外は一度だけ評価し，Bitsビットに符号拡張(Signとeが共に符号付きのとき)または0で拡張した値を保持する．
+template<unsigned int Bits, sign Sign, class E>
+constexpr auto make_operand_limbs(const E& e) noexcept {
+    using expr_t = std::remove_cvref_t<E>;
+    constexpr unsigned int bits = Bits ? Bits : bit_length_v<expr_t>;
+    if constexpr (requires { requires expr_t::length == int_representation<bits>::length; } && limb_sequence<expr_t>) {
+        return borrowed_limbs<expr_t::length>{e.data()};
+    } else if constexpr (Bits == 0) {
+        return owned_limbs<sign_v<expr_t>, bits>{expr_to_mp_int(e)};
+    } else {
+        decltype(auto) v = expr_to_mp_int(e);
+        using v_t = std::remove_cvref_t<decltype(v)>;
+        owned_limbs<Sign, Bits> r;
+        copy_limbs<v_t::sign_value & Sign, v_t::bit_length>(r.v.data(), r.length, v.data());
+        return r;
+    }
+}
+
+/// @brief a / b(Quotientがfalseならa % b)をBitsビットで求めてdestに書く．
+/// 被演算子の桁は幅が揃っていれば写さずに読み，destの桁数がBitsビットと同じなら結果を直接書く．
+template<sign Sign, unsigned int Bits, bool Quotient, class D, class E1, class E2>
+constexpr void divide_into(D& dest, const E1& e1, const E2& e2) noexcept {
+    constexpr unsigned int len = int_representation<Bits>::length;
+    const auto a = make_operand_limbs<Bits, Sign>(e1);
+    const auto b = make_operand_limbs<Bits, Sign>(e2);
+    int_representation<Bits> other;
+    if(D::length == len && dest.data() != a.data() && dest.data() != b.data()) {
+        if constexpr (Quotient) naive_mul::div_limbs<Sign, Bits>(dest.data(), other.poly.data(), a.data(), b.data());
+        else naive_mul::div_limbs<Sign, Bits>(other.poly.data(), dest.data(), a.data(), b.data());
+    } else {
+        // 代入先が被演算子と同じ桁の列か，幅が違うときは一時領域で計算する
+        int_representation<Bits> r;
+        if constexpr (Quotient) naive_mul::div_limbs<Sign, Bits>(r.poly.data(), other.poly.data(), a.data(), b.data());
+        else naive_mul::div_limbs<Sign, Bits>(other.poly.data(), r.poly.data(), a.data(), b.data());
+        std::copy_n(r.poly.data(), D::length, dest.data());
+    }
+    dest.normalize();
+}
+
+}
+
 /****** BIT OPERATION EXPRESSIONS ******/
 template<detail::expression E1, detail::expression E2>
 class or_expr : public detail::expression_base {
@@ -23,16 +233,22 @@ public:
         : e1_(e1)
         , e2_(e2)
     {}
-    template<sign Sign, unsigned int BW>
-    constexpr void evaluate(mp_int<Sign, BW>& dest) const noexcept {
-        dest = e1_;
-        detail::bitop::opor<Sign & sign_value>(dest.value_, expr_to_mp_int(e2_).value_);
+    template<detail::limb_destination D>
+    constexpr void evaluate(D& dest) const noexcept {
+        detail::fused_bitwise_evaluate<D::length>(dest.data(), limb_loader());
+        dest.normalize();
     }
     constexpr mp_int<sign_value, bit_length> evaluate() const noexcept {
-        mp_int<sign_value, bit_length> r(e1_);
-        detail::bitop::opor<sign_value>(r.value_, expr_to_mp_int(e2_).value_);
+        mp_int<sign_value, bit_length> r;
+        detail::fused_bitwise_evaluate(r.value_, limb_loader());
+        r.normalize();
         return r;
     }
+    constexpr auto limb_loader() const noexcept {
+        using l1_t = decltype(detail::make_limb_loader(e1_));
+        using l2_t = decltype(detail::make_limb_loader(e2_));
+        return detail::bitwise_limb_loader<std::bit_or<>, l1_t, l2_t>{detail::make_limb_loader(e1_), detail::make_limb_loader(e2_)};
+    }
 };
 template<detail::expression E1, detail::expression E2>
 class and_expr : public detail::expression_base {
@@ -49,16 +265,22 @@ public:
         : e1_(e1)
         , e2_(e2)
     {}
-    template<sign Sign, unsigned int BW>
-    constexpr void evaluate(mp_int<Sign, BW>& dest) const noexcept {
-        dest = e1_;
-        detail::bitop::opand<Sign & sign_value>(dest.value_, expr_to_mp_int(e2_).value_);
+    template<detail::limb_destination D>
+    constexpr void evaluate(D& dest) const noexcept {
+        detail::fused_bitwise_evaluate<D::length>(dest.data(), limb_loader());
+        dest.normalize();
     }
     constexpr mp_int<sign_value, bit_length> evaluate() const noexcept {
-        mp_int<sign_value, bit_length> r(e1_);
-        detail::bitop::opand<sign_value>(r.value_, expr_to_mp_int(e2_).value_);
+        mp_int<sign_value, bit_length> r;
+        detail::fused_bitwise_evaluate(r.value_, limb_loader());
+        r.normalize();
         return r;
     }
+    constexpr auto limb_loader() const noexcept {
+        using l1_t = decltype(detail::make_limb_loader(e1_));
+        using l2_t = decltype(detail::make_limb_loader(e2_));
+        return detail::bitwise_limb_loader<std::bit_and<>, l1_t, l2_t>{detail::make_limb_loader(e1_), detail::make_limb_loader(e2_)};
+    }
 };
 template<detail::expression E1, detail::expression E2>
 class xor_expr : public detail::expression_base {
@@ -75,18 +297,24 @@ public:
         : e1_(e1)
         , e2_(e2)
     {}
-    template<sign Sign, unsigned int BW>
-    constexpr void evaluate(mp_int<Sign, BW>& dest) const noexcept {
-        dest = e1_;
-        detail::bitop::opxor<Sign & sign_value>(dest.value_, expr_to_mp_int(e2_).value_);
+    template<detail::limb_destination D>
+    constexpr void evaluate(D& dest) const noexcept {
+        detail::fused_bitwise_evaluate<D::length>(dest.data(), limb_loader());
+        dest.normalize();
     }
     constexpr mp_int<sign_value, bit_length> evaluate() const noexcept {
-        mp_int<sign_value, bit_length> r(e1_);
-        detail::bitop::opxor<sign_value>(r.value_, expr_to_mp_int(e2_).value_);
+        mp_int<sign_value, bit_length> r;
+        detail::fused_bitwise_evaluate(r.value_, limb_loader());
+        r.normalize();
         return r;
     }
+    constexpr auto limb_loader() const noexcept {
+        using l1_t = decltype(detail::make_limb_loader(e1_));
+        using l2_t = decltype(detail::make_limb_loader(e2_));
+        return detail::bitwise_limb_loader<std::bit_xor<>, l1_t, l2_t>{detail::make_limb_loader(e1_), detail::make_limb_loader(e2_)};
+    }
 };
-template<detail::expression E1, detail::expression E2>
+template<detail::expression E1, class E2>
 class shiftr_expr : public detail::expression_base {
     const E1& e1_;
     const E2& e2_;
@@ -101,21 +329,26 @@ public:
         : e1_(e1)
         , e2_(e2)
     {}
-    template<sign Sign, unsigned int BW>
-    constexpr void evaluate(mp_int<Sign, BW>& dest) const noexcept {
+    template<detail::limb_destination D>
+    constexpr void evaluate(D& dest) const noexcept {
+        constexpr sign Sign = D::sign_value;
         assert(expr_to_mp_int(e2_).value_.msb() == false);
         dest = e1_;
-        detail::bitop::shiftr<Sign & sign_value>(dest.value_, (unsigned int)expr_to_mp_int(e2_).value_.poly[0]);
+        // 論理シフトでは余りのビットに入った符号拡張を引き込まないようにする
+        detail::normalize_limbs<Sign & sign_value, D::bit_length>(dest.data());
+        detail::bitop::shiftr_limbs<Sign & sign_value, D::bit_length>(dest.data(), (unsigned int)expr_to_mp_int(e2_).value_.poly[0]);
+        dest.normalize();
     }
     constexpr mp_int<sign_value, bit_length> evaluate() const noexcept {
         mp_int<sign_value, bit_length> r;
         assert(expr_to_mp_int(e2_).value_.msb() == false);
         r = e1_;
         detail::bitop::shiftr<sign_value>(r.value_, (unsigned int)expr_to_mp_int(e2_).value_.poly[0]);
+        r.normalize();
         return r;
     }
 };
-template<detail::expression E1, detail::expression E2>
+template<detail::expression E1, class E2>
 class shiftl_expr : public detail::expression_base {
     const E1& e1_;
     const E2& e2_;
@@ -130,16 +363,77 @@ public:
         : e1_(e1)
         , e2_(e2)
     {}
-    template<sign Sign, unsigned int BW>
-    constexpr void evaluate(mp_int<Sign, BW>& dest) const noexcept {
+    template<detail::limb_destination D>
+    constexpr void evaluate(D& dest) const noexcept {
         assert(expr_to_mp_int(e2_).value_.msb() == false);
         dest = e1_;
-        detail::bitop::shiftl<Sign & sign_value>(dest.value_, (unsigned int)expr_to_mp_int(e2_).value_.poly[0]);
+        detail::bitop::shiftl_limbs<D::bit_length>(dest.data(), (unsigned int)expr_to_mp_int(e2_).value_.poly[0]);
+        dest.normalize();
     }
     constexpr mp_int<sign_value, bit_length> evaluate() const noexcept {
         mp_int<sign_value, bit_length> r(e1_);
         assert(expr_to_mp_int(e2_).value_.msb() == false);
         detail::bitop::shiftl<sign_value>(r.value_, (unsigned int)expr_to_mp_int(e2_).value_.poly[0]);
+        r.normalize();
+        return r;
+    }
+};
+
+/// @brief シフト幅がコンパイル時定数(std::integral_constant)の右シフト
+template<detail::expression E1, std::integral T, T W>
+class shiftr_expr<E1, std::integral_constant<T, W>> : public detail::expression_base {
+    const E1& e1_;
+public:
+    static constexpr unsigned int bit_length = detail::bit_length_v<E1>;
+    static constexpr unsigned int length = detail::length_v<E1>;
+    static constexpr unsigned int size = detail::size_v<E1>;
+    static constexpr sign sign_value = detail::sign_v<E1>;
+    using coeff_type = typename detail::int_representation<bit_length>::coeff_type;
+    static_assert(W >= 0);
+
+    constexpr shiftr_expr(const E1& e1, std::integral_constant<T, W>)
+        : e1_(e1)
+    {}
+    template<detail::limb_destination D>
+    constexpr void evaluate(D& dest) const noexcept {
+        constexpr sign Sign = D::sign_value;
+        dest = e1_;
+        detail::normalize_limbs<Sign & sign_value, D::bit_length>(dest.data());
+        detail::bitop::shiftr_const<Sign & sign_value, (unsigned int)W, D::bit_length>(dest.data());
+        dest.normalize();
+    }
+    constexpr mp_int<sign_value, bit_length> evaluate() const noexcept {
+        mp_int<sign_value, bit_length> r(e1_);
+        detail::bitop::shiftr<sign_value, (unsigned int)W>(r.value_);
+        r.normalize();
+        return r;
+    }
+};
+/// @brief シフト幅がコンパイル時定数(std::integral_constant)の左シフト
+template<detail::expression E1, std::integral T, T W>
+class shiftl_expr<E1, std::integral_constant<T, W>> : public detail::expression_base {
+    const E1& e1_;
+public:
+    static constexpr unsigned int bit_length = detail::bit_length_v<E1>;
+    static constexpr unsigned int length = detail::length_v<E1>;
+    static constexpr unsigned int size = detail::size_v<E1>;
+    static constexpr sign sign_value = detail::sign_v<E1>;
+    using coeff_type = typename detail::int_representation<bit_length>::coeff_type;
+    static_assert(W >= 0);
+
+    constexpr shiftl_expr(const E1& e1, std::integral_constant<T, W>)
+        : e1_(e1)
+    {}
+    template<detail::limb_destination D>
+    constexpr void evaluate(D& dest) const noexcept {
+        dest = e1_;
+        detail::bitop::shiftl_const<(unsigned int)W, D::length>(dest.data());
+        dest.normalize();
+    }
+    constexpr mp_int<sign_value, bit_length> evaluate() const noexcept {
+        mp_int<sign_value, bit_length> r(e1_);
+        detail::bitop::shiftl<(unsigned int)W>(r.value_);
+        r.normalize();
         return r;
     }
 };
@@ -161,16 +455,23 @@ public:
         : e1_(e1)
         , e2_(e2)
     {}
-    template<sign Sign, unsigned int BW>
-    constexpr void evaluate(mp_int<Sign, BW>& dest) const noexcept {
-        dest = e1_;
-        detail::impl_base::plus(dest.value_, expr_to_mp_int(e2_).value_);
+    template<detail::limb_destination D>
+    constexpr void evaluate(D& dest) const noexcept {
+        detail::fused_sum_evaluate<D::length>(dest.data(), sum_loader<false>());
+        dest.normalize();
     }
     constexpr mp_int<sign_value, bit_length> evaluate() const noexcept {
-        mp_int<sign_value, bit_length> r(e1_);
-        detail::impl_base::plus(r.value_, expr_to_mp_int(e2_).value_);
+        mp_int<sign_value, bit_length> r;
+        detail::fused_sum_evaluate(r.value_, sum_loader<false>());
+        r.normalize();
         return r;
     }
+    template<bool Negate>
+    constexpr auto sum_loader() const noexcept {
+        using l1_t = decltype(detail::make_sum_loader<Negate>(e1_));
+        using l2_t = decltype(detail::make_sum_loader<Negate>(e2_));
+        return detail::sum_limb_loader<l1_t, l2_t>{detail::make_sum_loader<Negate>(e1_), detail::make_sum_loader<Negate>(e2_)};
+    }
 };
 
 template<detail::expression E1, detail::expression E2>
@@ -188,16 +489,23 @@ public:
         : e1_(e1)
         , e2_(e2)
     {}
-    template<sign Sign, unsigned int BW>
-    constexpr void evaluate(mp_int<Sign, BW>& dest) const noexcept {
-        dest = e1_;
-        detail::impl_base::minus(dest.value_, expr_to_mp_int(e2_).value_);
+    template<detail::limb_destination D>
+    constexpr void evaluate(D& dest) const noexcept {
+        detail::fused_sum_evaluate<D::length>(dest.data(), sum_loader<false>());
+        dest.normalize();
     }
     constexpr mp_int<sign_value, bit_length> evaluate() const noexcept {
-        mp_int<sign_value, bit_length> r(e1_);
-        detail::impl_base::minus(r.value_, expr_to_mp_int(e2_).value_);
+        mp_int<sign_value, bit_length> r;
+        detail::fused_sum_evaluate(r.value_, sum_loader<false>());
+        r.normalize();
         return r;
     }
+    template<bool Negate>
+    constexpr auto sum_loader() const noexcept {
+        using l1_t = decltype(detail::make_sum_loader<Negate>(e1_));
+        using l2_t = decltype(detail::make_sum_loader<!Negate>(e2_));
+        return detail::sum_limb_loader<l1_t, l2_t>{detail::make_sum_loader<Negate>(e1_), detail::make_sum_loader<!Negate>(e2_)};
+    }
 };
 template<detail::expression E1, detail::expression E2>
 class mul_expr : public detail::expression_base {
@@ -214,15 +522,29 @@ public:
         : e1_(e1)
         , e2_(e2)
     {}
-    template<sign Sign, unsigned int BW>
-    constexpr void evaluate(mp_int<Sign, BW>& dest) const noexcept {
-        detail::karatsuba::mul(dest.value_, expr_to_mp_int(e1_).value_, expr_to_mp_int(e2_).value_);
+    template<detail::limb_destination D>
+    constexpr void evaluate(D& dest) const noexcept {
+        // mp_intやmp_int_viewの被演算子は桁を写さずに読み，積は代入先の桁に直接書く
+        const auto a = detail::make_operand_limbs<0, sign_value>(e1_);
+        const auto b = detail::make_operand_limbs<0, sign_value>(e2_);
+        constexpr unsigned int la = decltype(a)::length, lb = decltype(b)::length;
+        if(dest.data() == a.data() || dest.data() == b.data()) {
+            // 代入先が被演算子と同じ桁の列なら一時領域で計算する
+            mp_int<D::sign_value, D::bit_length> r;
+            detail::karatsuba::mul_limbs<D::length, la, lb>(r.data(), a.data(), b.data());
+            std::copy_n(r.data(), D::length, dest.data());
+        } else {
+            detail::karatsuba::mul_limbs<D::length, la, lb>(dest.data(), a.data(), b.data());
+        }
+        dest.normalize();
     }
     constexpr mp_int<sign_value, bit_length> evaluate() const noexcept {
         mp_int<sign_value, bit_length> r;
-        detail::karatsuba::mul(r.value_, expr_to_mp_int(e1_).value_, expr_to_mp_int(e2_).value_);
+        evaluate(r);
         return r;
     }
+    constexpr const E1& lhs() const noexcept { return e1_; }
+    constexpr const E2& rhs() const noexcept { return e2_; }
 };
 template<detail::expression E1, detail::expression E2>
 class div_expr : public detail::expression_base {
@@ -239,15 +561,13 @@ public:
         : e1_(e1)
         , e2_(e2)
     {}
-    template<sign Sign, unsigned int BW>
-    constexpr void evaluate(mp_int<Sign, BW>& dest) const noexcept {
-        mp_int<Sign, BW> rem;
-        detail::naive_mul::div<sign_value & Sign, std::max(BW, bit_length)>(dest.value_, rem.value_, expr_to_mp_int(e1_).value_, expr_to_mp_int(e2_).value_);
+    template<detail::limb_destination D>
+    constexpr void evaluate(D& dest) const noexcept {
+        detail::divide_into<sign_value & D::sign_value, std::max(D::bit_length, bit_length), true>(dest, e1_, e2_);
     }
     constexpr mp_int<sign_value, bit_length> evaluate() const noexcept {
         mp_int<sign_value, bit_length> quo;
-        mp_int<sign_value, bit_length> rem;
-        detail::naive_mul::div<sign_value, bit_length>(quo.value_, rem.value_, expr_to_mp_int(e1_).value_, expr_to_mp_int(e2_).value_);
+        evaluate(quo);
         return quo;
     }
 };
@@ -266,15 +586,13 @@ public:
         : e1_(e1)
         , e2_(e2)
     {}
-    template<sign Sign, unsigned int BW>
-    constexpr void evaluate(mp_int<Sign, BW>& dest) const noexcept {
-        mp_int<Sign, BW> quo;
-        detail::naive_mul::div<sign_value & Sign, std::max(BW, bit_length)>(quo.value_, dest.value_, expr_to_mp_int(e1_).value_, expr_to_mp_int(e2_).value_);
+    template<detail::limb_destination D>
+    constexpr void evaluate(D& dest) const noexcept {
+        detail::divide_into<sign_value & D::sign_value, std::max(D::bit_length, bit_length), false>(dest, e1_, e2_);
     }
     constexpr mp_int<sign_value, bit_length> evaluate() const noexcept {
         mp_int<sign_value, bit_length> rem;
-        mp_int<sign_value, bit_length> quo;
-        detail::naive_mul::div<sign_value, bit_length>(quo.value_, rem.value_, expr_to_mp_int(e1_).value_, expr_to_mp_int(e2_).value_);
+        evaluate(rem);
         return rem;
     }
 };
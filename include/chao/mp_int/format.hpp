@@ -0,0 +1,143 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#if __has_include(<format>)
+#include <format>
+#endif
+
+#include "mp_int.hpp"
+#include "convertion.hpp"
+
+namespace chao::detail {
+
+/// @brief std::formatterの書式指定 [[fill]align][sign][#][0][width][grouping][type]．
+/// groupingは','か'_'で，10進数は3桁，それ以外は4桁ごとに区切る．typeはd, x, X, b, B, oのいずれか．
+struct format_spec {
+    char fill = ' ';
+    char align = '\0';
+    char sign = '-';
+    bool alternate = false;
+    bool zero_pad = false;
+    std::size_t width = 0;
+    char grouping = '\0';
+    char type = 'd';
+
+    /// @brief [first, last)から書式指定を読む
+    /// @return 読んだ末尾('}'の位置かlast)．書式が誤っていればnullptr
+    constexpr const char* parse(const char* first, const char* last) noexcept {
+        constexpr auto is_align = [](char c) { return c == '<' || c == '>' || c == '^'; };
+        if(last - first >= 2 && is_align(first[1]) && first[0] != '{' && first[0] != '}') {
+            fill = first[0];
+            align = first[1];
+            first += 2;
+        } else if(first != last && is_align(*first)) {
+            align = *first++;
+        }
+        if(first != last && (*first == '+' || *first == '-' || *first == ' ')) sign = *first++;
+        if(first != last && *first == '#') {
+            alternate = true;
+            ++first;
+        }
+        if(first != last && *first == '0') {
+            zero_pad = true;
+            ++first;
+        }
+        while(first != last && '0' <= *first && *first <= '9') width = width * 10 + (*first++ - '0');
+        if(first != last && (*first == ',' || *first == '_')) grouping = *first++;
+        if(first != last && *first != '}') {
+            switch(*first) {
+                case 'd': case 'x': case 'X': case 'b': case 'B': case 'o':
+                    type = *first++;
+                    break;
+                default:
+                    return nullptr;
+            }
+        }
+        if(first != last && *first != '}') return nullptr;
+        return first;
+    }
+    [[nodiscard]]
+    constexpr int base() const noexcept {
+        switch(type) {
+            case 'x': case 'X': return 16;
+            case 'b': case 'B': return 2;
+            case 'o': return 8;
+            default: return 10;
+        }
+    }
+
+    /// @brief 符号を除いた数字の列digitsに符号，接頭辞，区切り，埋め文字を付けてoutに書く
+    template<class OutputIt>
+    constexpr OutputIt write(OutputIt out, std::string_view digits, bool negative) const {
+        const char sign_char = negative ? '-' : sign != '-' ? sign : '\0';
+        std::string_view radix;
+        if(alternate) {
+            switch(type) {
+                case 'x': radix = "0x"; break;
+                case 'X': radix = "0X"; break;
+                case 'b': radix = "0b"; break;
+                case 'B': radix = "0B"; break;
+                case 'o': radix = digits == "0" ? "" : "0"; break;
+                default: break;
+            }
+        }
+        const std::size_t group = base() == 10 ? 3 : 4;
+        const std::size_t separators = grouping ? (digits.size() - 1) / group : 0;
+        const std::size_t len = (sign_char != '\0') + radix.size() + digits.size() + separators;
+        const std::size_t pad = width > len ? width - len : 0;
+        // 数値の既定は右寄せ．'0'は位置の指定が無いときだけ符号と接頭辞の後ろを0で埋める
+        std::size_t left = 0, zeros = 0;
+        if(!align && zero_pad) zeros = pad;
+        else if(!align || align == '>') left = pad;
+        else if(align == '^') left = pad / 2;
+        const std::size_t right = pad - left - zeros;
+
+        out = std::fill_n(out, left, fill);
+        if(sign_char) *out++ = sign_char;
+        out = std::copy(radix.begin(), radix.end(), out);
+        out = std::fill_n(out, zeros, '0');
+        for(std::size_t i = 0; i < digits.size(); ++i) {
+            if(separators && i && (digits.size() - i) % group == 0) *out++ = grouping;
+            char c = digits[i];
+            if(type == 'X' && 'a' <= c && c <= 'z') c -= 'a' - 'A';
+            *out++ = c;
+        }
+        return std::fill_n(out, right, fill);
+    }
+};
+
+}
+
+#if defined(__cpp_lib_format)
+namespace std {
+
+/// @brief mp_intと式のstd::formatter．数字はスタック上のバッファにto_charsで書き，
+/// 書式を付けながら出力イテレータへ直接書き込むので，文字列は確保しない．
+/// 大きな値の10進数の変換では，to_charsがスレッドごとの表と作業領域を初めの1回だけ確保する．
+/// 標準ライブラリが__cpp_lib_formatを定義するとき(libstdc++ 13以降など)だけ定義される．
+/// g++ 12ではこの特殊化はコンパイルされず，書式の解釈と出力はdetail::format_specを直接使って試験する．
+template<chao::detail::derived_expression E>
+struct formatter<E, char> {
+    constexpr auto parse(format_parse_context& ctx) {
+        const char* first = std::to_address(ctx.begin());
+        const char* p = spec_.parse(first, std::to_address(ctx.end()));
+        if(!p) throw format_error("invalid format spec for mp_int.");
+        return ctx.begin() + (p - first);
+    }
+    template<class FormatContext>
+    auto format(const E& e, FormatContext& ctx) const {
+        std::array<char, chao::detail::max_chars(chao::detail::bit_length_v<E>, 2) + 1> buffer;
+        const auto r = chao::to_chars(buffer.data(), buffer.data() + buffer.size(), e, spec_.base());
+        const bool negative = buffer[0] == '-';
+        const std::string_view digits(buffer.data() + negative, r.ptr - buffer.data() - negative);
+        return spec_.write(ctx.out(), digits, negative);
+    }
+private:
+    chao::detail::format_spec spec_;
+};
+
+}
+#endif
@@ -1,25 +1,60 @@
 #pragma once
+#include <array>
 #include <istream>
 #include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
 
 #include "mp_int.hpp"
 #include "convertion.hpp"
 
 namespace chao {
 
+/// @brief スタック上のバッファに10進数で書いてから出力する．幅と埋め文字の指定は文字列と同じく効く．
 template<detail::derived_expression E>
 std::ostream& operator<<(std::ostream& os, E&& e) {
-    return os << to_string(expr_to_mp_int(std::forward<E>(e)));
+    std::array<char, detail::max_chars(detail::bit_length_v<std::remove_cvref_t<E>>, 10) + 1> buffer;
+    const auto r = to_chars(buffer.data(), buffer.data() + buffer.size(), e);
+    return os << std::string_view(buffer.data(), r.ptr - buffer.data());
 }
 
+/// @brief 空白を読み飛ばし，続く10進数をスタック上のバッファに読んでからfrom_charsで変換する．
+/// 先頭の0はバッファに入れずに読み飛ばし，収まらない桁数の入力も数字の並びの終わりまで読んでから報告する．
+/// 数字が無ければstd::invalid_argument，値が型に収まらなければstd::out_of_rangeを投げる．
 template<sign Sign, unsigned int BitWidth>
 std::istream& operator>>(std::istream& is, mp_int<Sign, BitWidth>& n) {
-    std::string s;
-    is >> s;
-    if constexpr (Sign == sign::mp_signed) {
-        n = chao::stoi<BitWidth>(s);
-    } else {
-        n = chao::stoul<BitWidth>(s);
+    using traits = std::istream::traits_type;
+    std::istream::sentry sentry(is);
+    if(!sentry) return is;
+    // 符号と，収まる桁数より1文字多い数字が入れば範囲外と分かる
+    std::array<char, detail::max_chars(BitWidth, 10) + 2> buffer;
+    std::size_t len = 0;
+    const auto next_digit = [&is]() -> int {
+        const auto c = is.peek();
+        return c == traits::eof() ? -1 : detail::digit(traits::to_char_type(c), 10);
+    };
+    if(Sign == sign::mp_signed && is.peek() == traits::to_int_type('-')) {
+        buffer[len++] = '-';
+        is.get();
+    }
+    bool zero = false;
+    while(next_digit() == 0) {
+        zero = true;
+        is.get();
+    }
+    if(zero && next_digit() < 0) buffer[len++] = '0';
+    for(int d; (d = next_digit()) >= 0; is.get()) {
+        if(len < buffer.size()) buffer[len++] = (char)('0' + d);
+    }
+    const auto r = from_chars(buffer.data(), buffer.data() + len, n);
+    if(r.ec == std::errc::invalid_argument) {
+        is.setstate(std::ios_base::failbit);
+        throw std::invalid_argument("can't convert into mp_int from stream.");
+    }
+    if(r.ec == std::errc::result_out_of_range) {
+        is.setstate(std::ios_base::failbit);
+        throw std::out_of_range("mp_int read from stream is out of range.");
     }
     return is;
 }
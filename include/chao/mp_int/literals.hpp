@@ -1,42 +1,116 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
 
 #include "mp_int.hpp"
 #include "convertion.hpp"
 
 namespace chao{
-inline namespace literals {
-inline namespace mp_int_literals {
 
-constexpr int128_t operator"" _i128(const char* number_str) noexcept {
-    return stoi<128>(number_str);
-}
-constexpr int192_t operator"" _i192(const char* number_str) noexcept {
-    return stoi<192>(number_str);
-}
-constexpr int256_t operator"" _i256(const char* number_str) noexcept {
-    return stoi<256>(number_str);
-}
-constexpr int384_t operator"" _i384(const char* number_str) noexcept {
-    return stoi<384>(number_str);
+namespace detail {
+
+/// @brief リテラルの基数．接頭辞"0x", "0b", "0o"だけを見て，それ以外は先頭が0でも10進数とする．
+constexpr int literal_base(std::string_view s) noexcept {
+    if(s.size() < 2 || s.front() != '0') return 10;
+    switch(s[1]) {
+        case 'x': [[fallthrough]];
+        case 'X':
+            return 16;
+        case 'b': [[fallthrough]];
+        case 'B':
+            return 2;
+        case 'o': [[fallthrough]];
+        case 'O':
+            return 8;
+        default:
+            return 10;
+    }
 }
-constexpr int384_t operator"" _i512(const char* number_str) noexcept {
-    return stoi<512>(number_str);
+
+/// @brief 整数リテラルの文字列を読む．接頭辞"0x", "0b", "0o"で基数を決め(先頭の0だけなら10進数)，
+/// 符号なしとして読んでから(組み込みの整数と同じく)Signの型に変換する．
+/// 数字でない文字や型に収まらない値は定数式ではコンパイルエラーになる．
+template<sign Sign, unsigned int BitWidth>
+constexpr mp_int<Sign, BitWidth> parse_literal(std::string_view s) {
+    const int base = literal_base(s);
+    s.remove_prefix(base == 10 ? 0 : 2);
+    mp_int<sign::mp_unsigned, BitWidth> r = 0;
+    const auto [p, ec] = from_chars(s.data(), s.data() + s.size(), r, base);
+    if(ec != std::errc{} || p != s.data() + s.size()) throw std::invalid_argument("invalid mp_int literal.");
+    return mp_int<Sign, BitWidth>(r);
 }
 
-constexpr uint128_t operator"" _u128(const char* number_str) noexcept {
-    return stoul<128>(number_str);
+/// @brief リテラルの文字から桁区切り'\''を除いた0終端の文字列
+template<char ...Cs>
+inline constexpr auto literal_digits = [] {
+    std::array<char, sizeof...(Cs) + 1> a{};
+    std::size_t n = 0;
+    for(char c : {Cs...}) {
+        if(c != '\'') a[n++] = c;
+    }
+    return a;
+}();
+
+/// @brief リテラルの値のビット数．桁数から決まる幅で一度読んでから数える．
+template<char ...Cs>
+consteval unsigned int literal_bit_width() {
+    constexpr std::string_view s(literal_digits<Cs...>.data());
+    constexpr int base = literal_base(s);
+    constexpr unsigned int bound = std::max<unsigned int>(64, (s.size() * std::bit_width((unsigned int)base - 1) + 63) / 64 * 64);
+    const auto v = parse_literal<sign::mp_unsigned, bound>(s);
+    const auto len = impl_base::active_length(v.value_.poly.data(), v.length);
+    return len ? (len - 1) * 64 + std::bit_width(v.value_.poly[len - 1]) : 0;
 }
-constexpr uint192_t operator"" _u192(const char* number_str) noexcept {
-    return stoul<192>(number_str);
+
+template<sign Sign, unsigned int BitWidth, char ...Cs>
+consteval mp_int<Sign, BitWidth> literal() {
+    return parse_literal<Sign, BitWidth>(literal_digits<Cs...>.data());
 }
-constexpr uint256_t operator"" _u256(const char* number_str) noexcept {
-    return stoul<256>(number_str);
+
 }
-constexpr uint384_t operator"" _u384(const char* number_str) noexcept {
-    return stoul<384>(number_str);
+
+inline namespace literals {
+inline namespace mp_int_literals {
+
+/// @brief 値が収まる最小の幅(64ビットの倍数)の符号付きmp_int．
+/// 符号ビットの分を空けるので，-0x8000'0000'0000'0000_mpは128ビットになる．
+/// 10進，0x，0bと桁区切りを受け付け，コンパイル時に読む．先頭の0は8進数の接頭辞ではなく，0123_mpは123になる．
+template<char ...Cs>
+consteval auto operator"" _mp() {
+    constexpr unsigned int width = std::max(64u, (detail::literal_bit_width<Cs...>() + 1 + 63) / 64 * 64);
+    return detail::literal<sign::mp_signed, width, Cs...>();
 }
-constexpr uint384_t operator"" _u512(const char* number_str) noexcept {
-    return stoul<512>(number_str);
+/// @brief 値が収まる最小の幅(64ビットの倍数)の符号なしmp_int
+template<char ...Cs>
+consteval auto operator"" _ump() {
+    constexpr unsigned int width = std::max(64u, (detail::literal_bit_width<Cs...>() + 63) / 64 * 64);
+    return detail::literal<sign::mp_unsigned, width, Cs...>();
 }
 
+template<char ...Cs>
+consteval int128_t operator"" _i128() { return detail::literal<sign::mp_signed, 128, Cs...>(); }
+template<char ...Cs>
+consteval int192_t operator"" _i192() { return detail::literal<sign::mp_signed, 192, Cs...>(); }
+template<char ...Cs>
+consteval int256_t operator"" _i256() { return detail::literal<sign::mp_signed, 256, Cs...>(); }
+template<char ...Cs>
+consteval int384_t operator"" _i384() { return detail::literal<sign::mp_signed, 384, Cs...>(); }
+template<char ...Cs>
+consteval int512_t operator"" _i512() { return detail::literal<sign::mp_signed, 512, Cs...>(); }
+
+template<char ...Cs>
+consteval uint128_t operator"" _u128() { return detail::literal<sign::mp_unsigned, 128, Cs...>(); }
+template<char ...Cs>
+consteval uint192_t operator"" _u192() { return detail::literal<sign::mp_unsigned, 192, Cs...>(); }
+template<char ...Cs>
+consteval uint256_t operator"" _u256() { return detail::literal<sign::mp_unsigned, 256, Cs...>(); }
+template<char ...Cs>
+consteval uint384_t operator"" _u384() { return detail::literal<sign::mp_unsigned, 384, Cs...>(); }
+template<char ...Cs>
+consteval uint512_t operator"" _u512() { return detail::literal<sign::mp_unsigned, 512, Cs...>(); }
+
 }}}
@@ -1,6 +1,8 @@
 #pragma once
+#include <algorithm>
 #include <tuple>
 #include "mp_int.hpp"
+#include "operators.hpp"
 
 namespace chao{
 
@@ -54,4 +56,116 @@ template<class Int>
 constexpr Int mod_abs(const Int& a, const Int m) noexcept {
     return a < 0 ? (Int)(a % m + m) : (Int)(a % m);
 }
+
+namespace detail {
+
+/// @brief n語の列pのうち第kビットより上が全てfillと等しいか
+constexpr bool upper_bits_equal(const impl_base::int_type* p, unsigned int n, unsigned int k, impl_base::int_type fill) noexcept {
+    for(auto i = k / 64; i < n; ++i) {
+        const impl_base::int_type mask = i == k / 64 ? ~(impl_base::int_type)0 << (k % 64) : ~(impl_base::int_type)0;
+        if((p[i] ^ fill) & mask) return false;
+    }
+    return true;
+}
+/// @brief 正確な値 s + h * 2^(64n) をoutに切り詰めて書く．sはn語の列．
+/// @return 値がoutの型で表せないときtrue
+template<sign Sign, unsigned int BitWidth>
+constexpr bool store_wide(const impl_base::int_type* s, unsigned int n, int h, mp_int<Sign, BitWidth>& out) noexcept {
+    const impl_base::int_type fill = h < 0 ? ~(impl_base::int_type)0 : 0;
+    bool overflow = true;
+    if(h == 0 || (Sign == sign::mp_signed && h == -1)) {
+        // 符号付きなら第BitWidth-1ビットから上が，符号なしなら第BitWidthビットから上がfillに揃っていれば収まる
+        overflow = !upper_bits_equal(s, n, Sign == sign::mp_signed ? BitWidth - 1 : BitWidth, fill);
+    }
+    for(auto i = 0u; i < out.length; ++i) out.value_.poly[i] = i < n ? s[i] : fill;
+    out.normalize();
+    return overflow;
+}
+/// @brief 語の幅に揃えた一時領域でx + y(Subならx - y)を求めてoutに書く．幅や符号の異なる組み合わせに使う．
+template<bool Sub, class X, class Y, sign Sign, unsigned int BitWidth>
+constexpr bool add_sub_overflow(const X& x, const Y& y, mp_int<Sign, BitWidth>& out) noexcept {
+    constexpr unsigned int n = std::max({X::length, Y::length, mp_int<Sign, BitWidth>::length});
+    // 符号付きで負のオペランドは，n語に符号拡張すると2^(64n)だけ大きく見える
+    const int sx = X::sign_value == sign::mp_signed && x.value_.msb();
+    const int sy = Y::sign_value == sign::mp_signed && y.value_.msb();
+    int_representation<64 * n> s;
+    s.template cpy<X::sign_value>(x.value_);
+    int h;
+    if constexpr (Sub) {
+        const bool no_borrow = impl_base::minus_ext<Y::sign_value>(s, y.value_);
+        h = sy - sx - !no_borrow;
+    } else {
+        const bool carry = impl_base::plus_ext<Y::sign_value>(s, y.value_);
+        h = carry - sx - sy;
+    }
+    return store_wide(s.poly.data(), n, h, out);
+}
+
+}
+
+/// @brief out = a + b．__builtin_add_overflowと同じく，a, bの正確な値の和を求めてからoutの型に切り詰める．
+/// @return 正確な和がoutの型で表せない(桁あふれした)ときtrue
+template<detail::expression L, detail::expression R, sign Sign, unsigned int BitWidth>
+constexpr bool add_overflow(const L& a, const R& b, mp_int<Sign, BitWidth>& out) noexcept {
+    using T = mp_int<Sign, BitWidth>;
+    if constexpr (std::is_same_v<L, T> && std::is_same_v<R, T> && BitWidth % 64 == 0) {
+        // 同じ型同士なら，符号なしは繰り上がり，符号付きは同符号の和の符号が変わったかで判定する
+        const bool sx = a.value_.msb(), sy = b.value_.msb();
+        bool carry;
+        if(&out == &b) {
+            carry = detail::impl_base::plus(out.value_, a.value_);
+        } else {
+            out = a;
+            carry = detail::impl_base::plus(out.value_, b.value_);
+        }
+        if constexpr (Sign == sign::mp_unsigned) return carry;
+        else return sx == sy && out.value_.msb() != sx;
+    } else {
+        decltype(auto) x = expr_to_mp_int(a);
+        decltype(auto) y = expr_to_mp_int(b);
+        return detail::add_sub_overflow<false>(x, y, out);
+    }
+}
+
+/// @brief out = a - b．__builtin_sub_overflowと同じく，a, bの正確な値の差を求めてからoutの型に切り詰める．
+/// @return 正確な差がoutの型で表せない(桁あふれした)ときtrue
+template<detail::expression L, detail::expression R, sign Sign, unsigned int BitWidth>
+constexpr bool sub_overflow(const L& a, const R& b, mp_int<Sign, BitWidth>& out) noexcept {
+    using T = mp_int<Sign, BitWidth>;
+    if constexpr (std::is_same_v<L, T> && std::is_same_v<R, T> && BitWidth % 64 == 0) {
+        // 符号なしは借り，符号付きは異符号の差の符号がaと変わったかで判定する
+        if(&out != &b) {
+            const bool sx = a.value_.msb(), sy = b.value_.msb();
+            out = a;
+            const bool no_borrow = detail::impl_base::minus(out.value_, b.value_);
+            if constexpr (Sign == sign::mp_unsigned) return !no_borrow;
+            else return sx != sy && out.value_.msb() != sx;
+        }
+    }
+    decltype(auto) x = expr_to_mp_int(a);
+    decltype(auto) y = expr_to_mp_int(b);
+    return detail::add_sub_overflow<true>(x, y, out);
+}
+
+/// @brief out = a * b．__builtin_mul_overflowと同じく，a, bの正確な値の積を求めてからoutの型に切り詰める．
+/// @return 正確な積がoutの型で表せない(桁あふれした)ときtrue
+template<detail::expression L, detail::expression R, sign Sign, unsigned int BitWidth>
+constexpr bool mul_overflow(const L& a, const R& b, mp_int<Sign, BitWidth>& out) noexcept {
+    decltype(auto) x = expr_to_mp_int(a);
+    decltype(auto) y = expr_to_mp_int(b);
+    using X = std::remove_cvref_t<decltype(x)>;
+    using Y = std::remove_cvref_t<decltype(y)>;
+    // 語の列を符号なしとみなした積を求め，負のオペランドの分を上半分から引いて符号付きの積に直す．
+    // 積はlx + ly語に必ず収まるので，上位の語が符号拡張になっているかで桁あふれが分かる．
+    detail::int_representation<64 * (X::length + Y::length)> p;
+    detail::karatsuba::mul(p, x.value_, y.value_);
+    if(X::sign_value == sign::mp_signed && x.value_.msb()) {
+        detail::impl_base::sub_n(p.poly.data() + X::length, y.value_.poly.data(), Y::length);
+    }
+    if(Y::sign_value == sign::mp_signed && y.value_.msb()) {
+        detail::impl_base::sub_n(p.poly.data() + Y::length, x.value_.poly.data(), X::length);
+    }
+    constexpr bool any_signed = X::sign_value == sign::mp_signed || Y::sign_value == sign::mp_signed;
+    return detail::store_wide(p.poly.data(), p.length, any_signed && p.msb() ? -1 : 0, out);
+}
 }
@@ -0,0 +1,154 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <new>
+
+namespace chao::pmr {
+
+/// @brief 利用者が与えたバッファから切り出すだけのメモリリソース．
+/// 式の一時オブジェクトや文字列変換の作業領域のように，確保した順と逆順に解放される領域に向く．
+/// 最後に確保した領域が解放されたときだけその分を巻き戻し，それ以外の解放では何もしない．
+/// バッファが尽きたらupstreamから確保する．
+class limb_arena : public std::pmr::memory_resource {
+public:
+    /// @brief rewindに渡す巻き戻し位置
+    using marker = std::byte*;
+
+    limb_arena(void* buffer, std::size_t size, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+        : begin_(static_cast<std::byte*>(buffer))
+        , end_(begin_ + size)
+        , current_(begin_)
+        , upstream_(upstream)
+    {}
+    limb_arena(const limb_arena&) = delete;
+    limb_arena& operator=(const limb_arena&) = delete;
+
+    /// @brief バッファ全体を未使用に戻す．バッファから確保した領域は全て無効になる．
+    void release() noexcept { current_ = begin_; }
+    [[nodiscard]]
+    marker mark() const noexcept { return current_; }
+    /// @brief markを呼んだ時点まで巻き戻す．その後にバッファから確保した領域は全て無効になる．
+    void rewind(marker m) noexcept { current_ = m; }
+    /// @brief バッファのうち使用中のバイト数
+    [[nodiscard]]
+    std::size_t used() const noexcept { return static_cast<std::size_t>(current_ - begin_); }
+    [[nodiscard]]
+    std::pmr::memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* p = current_;
+        std::size_t space = static_cast<std::size_t>(end_ - current_);
+        if(std::align(alignment, bytes, p, space)) {
+            current_ = static_cast<std::byte*>(p) + bytes;
+            return p;
+        }
+        return upstream_->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        std::byte* b = static_cast<std::byte*>(p);
+        if(!owns(b)) return upstream_->deallocate(p, bytes, alignment);
+        if(b + bytes == current_) current_ = b;
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    std::byte* begin_;
+    std::byte* end_;
+    std::byte* current_;
+    std::pmr::memory_resource* upstream_;
+
+    bool owns(const std::byte* p) const noexcept {
+        return std::less_equal<const std::byte*>{}(begin_, p) && std::less<const std::byte*>{}(p, end_);
+    }
+};
+
+/// @brief 桁のバッファを2^k桁ごとのサイズクラスで使い回すメモリリソース．
+/// basic_dynamic_mp_intは容量を2の冪に揃えるので，一度確保した大きさのバッファは
+/// 解放後に同じ大きさの要求でそのまま再利用される．
+/// 最大のサイズクラスを超える要求はupstreamにそのまま渡す．
+class limb_pool : public std::pmr::memory_resource {
+public:
+    /// @brief サイズクラスの数．最大で2^(class_count-1)桁のバッファをプールする．
+    static constexpr unsigned int class_count = 16;
+    static constexpr std::size_t min_block_size = sizeof(std::uint64_t);
+    static constexpr std::size_t max_block_size = min_block_size << (class_count - 1);
+
+    explicit limb_pool(std::pmr::memory_resource* upstream = std::pmr::get_default_resource(), std::size_t chunk_size = 4096) noexcept
+        : free_{}
+        , chunks_(nullptr)
+        , chunk_size_(chunk_size)
+        , upstream_(upstream)
+    {}
+    limb_pool(const limb_pool&) = delete;
+    limb_pool& operator=(const limb_pool&) = delete;
+    ~limb_pool() override { release(); }
+
+    /// @brief プールしている領域を全てupstreamに返す．確保済みの領域は全て無効になる．
+    void release() noexcept {
+        while(chunks_) {
+            chunk_header* next = chunks_->next;
+            upstream_->deallocate(chunks_, chunks_->bytes, alignof(std::max_align_t));
+            chunks_ = next;
+        }
+        free_.fill(nullptr);
+    }
+    [[nodiscard]]
+    std::pmr::memory_resource* upstream_resource() const noexcept { return upstream_; }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if(bytes > max_block_size || alignment > alignof(std::max_align_t)) return upstream_->allocate(bytes, alignment);
+        const unsigned int k = size_class(bytes);
+        if(!free_[k]) refill(k);
+        free_block* b = free_[k];
+        free_[k] = b->next;
+        return b;
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        if(bytes > max_block_size || alignment > alignof(std::max_align_t)) return upstream_->deallocate(p, bytes, alignment);
+        const unsigned int k = size_class(bytes);
+        free_block* b = ::new(p) free_block{free_[k]};
+        free_[k] = b;
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    struct free_block { free_block* next; };
+    struct alignas(std::max_align_t) chunk_header {
+        chunk_header* next;
+        std::size_t bytes;
+    };
+    std::array<free_block*, class_count> free_;
+    chunk_header* chunks_;
+    std::size_t chunk_size_;
+    std::pmr::memory_resource* upstream_;
+
+    static unsigned int size_class(std::size_t bytes) noexcept {
+        const std::size_t limbs = (bytes + min_block_size - 1) / min_block_size;
+        return limbs <= 1 ? 0 : static_cast<unsigned int>(std::bit_width(limbs - 1));
+    }
+    /// @brief upstreamからchunk_size_程度の領域を確保し，サイズクラスkのブロックに切り分ける
+    void refill(unsigned int k) {
+        const std::size_t block = min_block_size << k;
+        const std::size_t count = chunk_size_ > block ? chunk_size_ / block : 1;
+        const std::size_t bytes = sizeof(chunk_header) + block * count;
+        void* p = upstream_->allocate(bytes, alignof(std::max_align_t));
+        chunks_ = ::new(p) chunk_header{chunks_, bytes};
+        std::byte* first = static_cast<std::byte*>(p) + sizeof(chunk_header);
+        for(std::size_t i = count; i-- > 0;) {
+            free_[k] = ::new(first + i * block) free_block{free_[k]};
+        }
+    }
+};
+
+}
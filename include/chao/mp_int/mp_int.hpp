@@ -46,20 +46,29 @@ public:
     static constexpr unsigned int bit_length = detail::int_representation<BitWidth>::bit_length;
     static constexpr unsigned int length = detail::int_representation<BitWidth>::length;
     static constexpr unsigned int size = detail::int_representation<BitWidth>::size;
+    /// @brief 最上位桁のうちBitWidthより上にある余りのビット数．
+    /// カーネルはこの部分に桁上がりを溜めてからnormalizeで切り捨ててよい．
+    static constexpr unsigned int spare_bits = detail::int_representation<BitWidth>::spare_bits;
     static constexpr sign sign_value = Sign;
     using coeff_type = typename detail::int_representation<BitWidth>::coeff_type;
 
     mp_int() = default;
     explicit mp_int(const detail::int_representation<BitWidth>& i) noexcept 
         : value_(i)
-    {}
+    {
+        normalize();
+    }
     explicit mp_int(std::initializer_list<typename detail::int_representation<BitWidth>::coeff_type>&& il) noexcept
         : value_(il)
-    {}
+    {
+        normalize();
+    }
     template<std::integral T>
     constexpr mp_int(T i) noexcept
         : value_(i)
-    {}
+    {
+        normalize();
+    }
     template<detail::derived_expression T>
     constexpr mp_int(T&& e) noexcept {
         *this = e;
@@ -68,11 +77,14 @@ public:
     constexpr mp_int(const mp_int<OtherSign, OtherBW>& other) noexcept
     {
         value_.template cpy<OtherSign & Sign>(other.value_);
+        normalize();
     }
 
     template<sign OtherSign, unsigned int OtherBW>
     constexpr mp_int& operator=(const mp_int<OtherSign, OtherBW>& o) & noexcept {
-        value_.poly.template cpy<OtherSign, OtherBW>(o.value_);
+        value_.template cpy<OtherSign, OtherBW>(o.value_);
+        normalize();
+        return *this;
     }
 
     template<detail::derived_expression T>
@@ -83,6 +95,7 @@ public:
     template<class T>
     mp_int& operator=(T&& e) & noexcept {
         value_ = e;
+        normalize();
         return *this;
     }
 
@@ -122,15 +135,21 @@ public:
         return (*this <=> c) == std::strong_ordering::equal;
     }
 
-    template<sign S, unsigned int BW>
-    constexpr void evaluate(mp_int<S, BW>& dest) const noexcept {
-        dest.value_.template cpy<S>(value_);
+    template<detail::limb_destination D>
+    constexpr void evaluate(D& dest) const noexcept {
+        detail::copy_limbs<D::sign_value, BitWidth>(dest.data(), D::length, value_.poly.data());
+        dest.normalize();
     }
     [[nodiscard]]
     constexpr const mp_int& evaluate() const noexcept
     {
         return *this;
     }
+    /// @brief 下位から並んだlength個の桁
+    [[nodiscard]]
+    constexpr coeff_type* data() noexcept { return value_.poly.data(); }
+    [[nodiscard]]
+    constexpr const coeff_type* data() const noexcept { return value_.poly.data(); }
     [[nodiscard]]
     constexpr operator bool() const noexcept { return (bool)value_; }
     [[nodiscard]]
@@ -148,8 +167,13 @@ public:
     constexpr mp_int operator~() const noexcept {
         mp_int tmp = *this;
         detail::bitop::opnot(tmp.value_);
+        tmp.normalize();
         return tmp;
     }
+    /// @brief 最上位桁の余りのビットを値の符号に合わせて揃える．BitWidthが64の倍数なら何もしない．
+    constexpr void normalize() noexcept {
+        value_.template normalize<Sign>();
+    }
     // prefix
     constexpr const mp_int& operator++() & noexcept {
         return *this += 1;
@@ -218,5 +242,7 @@ typedef mp_int<sign::mp_signed, 256> int256_t;
 typedef mp_int<sign::mp_unsigned, 256> uint256_t;
 typedef mp_int<sign::mp_signed, 384> int384_t;
 typedef mp_int<sign::mp_unsigned, 384> uint384_t;
+typedef mp_int<sign::mp_signed, 512> int512_t;
+typedef mp_int<sign::mp_unsigned, 512> uint512_t;
 
 }
@@ -0,0 +1,304 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CHAO_MP_INT_FILE_MMAP 1
+#endif
+
+#include "mp_int.hpp"
+#include "expression.hpp"
+#include "convertion.hpp"
+#include "mp_int_view.hpp"
+
+namespace chao {
+
+/// @brief mp_intの固定長レコードを並べたファイルのヘッダ．
+/// 整数の各欄は桁と同じバイト順で書く．レコードはヘッダの直後から，各レコードの桁を下位から順に詰めて並べる．
+struct mp_int_file_header {
+    static constexpr char magic_value[8] = {'C', 'H', 'A', 'O', 'M', 'P', 'I', '\0'};
+    static constexpr std::uint32_t current_version = 1;
+    static constexpr std::uint32_t signed_flag = 1;
+    static constexpr std::uint32_t big_endian_flag = 2;
+
+    char magic[8];
+    std::uint32_t version;
+    /// @brief signed_flag | big_endian_flag
+    std::uint32_t flags;
+    std::uint32_t bit_width;
+    /// @brief 1レコードの桁数
+    std::uint32_t limb_count;
+    std::uint64_t record_count;
+    /// @brief レコードを64バイト境界から始めるための予約領域
+    std::byte reserved[32];
+};
+static_assert(sizeof(mp_int_file_header) == 64);
+
+namespace detail {
+
+[[noreturn]]
+inline void throw_file_error(const char* what, const std::filesystem::path& path) {
+    throw std::system_error(errno, std::generic_category(), std::string(what) + ": " + path.string());
+}
+
+/// @brief ファイル全体を読み取り専用で参照する．mmapが使えればファイルを写像し，使えなければ全体を読み込む．
+class mapped_file {
+public:
+    explicit mapped_file(const std::filesystem::path& path) {
+#if defined(CHAO_MP_INT_FILE_MMAP)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0) throw_file_error("can't open", path);
+        struct stat st;
+        if(::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw_file_error("can't stat", path);
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if(size_) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(p == MAP_FAILED) {
+                ::close(fd);
+                throw_file_error("can't map", path);
+            }
+            ::madvise(p, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const std::byte*>(p);
+        }
+        ::close(fd);
+#else
+        std::FILE* f = std::fopen(path.string().c_str(), "rb");
+        if(!f) throw_file_error("can't open", path);
+        std::fseek(f, 0, SEEK_END);
+        size_ = static_cast<std::size_t>(std::ftell(f));
+        std::fseek(f, 0, SEEK_SET);
+        // 桁として読めるように8バイト単位で確保する
+        buffer_.resize((size_ + 7) / 8);
+        const bool ok = std::fread(buffer_.data(), 1, size_, f) == size_;
+        std::fclose(f);
+        if(!ok) throw_file_error("can't read", path);
+        data_ = reinterpret_cast<const std::byte*>(buffer_.data());
+#endif
+    }
+    mapped_file(mapped_file&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+#if !defined(CHAO_MP_INT_FILE_MMAP)
+        , buffer_(std::move(other.buffer_))
+#endif
+    {}
+    mapped_file& operator=(mapped_file&& other) noexcept {
+        if(this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+#if !defined(CHAO_MP_INT_FILE_MMAP)
+            buffer_ = std::move(other.buffer_);
+#endif
+        }
+        return *this;
+    }
+    ~mapped_file() { unmap(); }
+
+    [[nodiscard]]
+    const std::byte* data() const noexcept { return data_; }
+    [[nodiscard]]
+    std::size_t size() const noexcept { return size_; }
+
+private:
+    const std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+#if !defined(CHAO_MP_INT_FILE_MMAP)
+    std::vector<std::uint64_t> buffer_;
+#endif
+
+    void unmap() noexcept {
+#if defined(CHAO_MP_INT_FILE_MMAP)
+        if(data_) ::munmap(const_cast<std::byte*>(data_), size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+};
+
+template<sign Sign, unsigned int BitWidth>
+constexpr std::uint32_t mp_int_file_flags() noexcept {
+    return (Sign == sign::mp_signed ? mp_int_file_header::signed_flag : 0)
+        | (std::endian::native == std::endian::big ? mp_int_file_header::big_endian_flag : 0);
+}
+
+}
+
+/// @brief mp_intのレコードファイルをmmapで読む．レコードはコピーせずにファイル上の桁を直接参照する．
+/// ファイルの符号，ビット幅，桁のバイト順がこの型と一致しなければstd::runtime_errorを投げる．
+template<sign Sign, unsigned int BitWidth>
+class mp_int_file_reader {
+public:
+    using value_type = mp_int<Sign, BitWidth>;
+    static constexpr unsigned int length = value_type::length;
+    static_assert(sizeof(value_type) == length * sizeof(std::uint64_t) && alignof(value_type) <= alignof(mp_int_file_header));
+
+    explicit mp_int_file_reader(const std::filesystem::path& path)
+        : file_(path)
+    {
+        if(file_.size() < sizeof(mp_int_file_header)) throw std::runtime_error("not an mp_int file: " + path.string());
+        mp_int_file_header h;
+        std::memcpy(&h, file_.data(), sizeof(h));
+        if(std::memcmp(h.magic, mp_int_file_header::magic_value, sizeof(h.magic)) != 0) {
+            throw std::runtime_error("not an mp_int file: " + path.string());
+        }
+        if(h.version != mp_int_file_header::current_version) {
+            throw std::runtime_error("unsupported mp_int file version or limb endianness: " + path.string());
+        }
+        if(h.flags != detail::mp_int_file_flags<Sign, BitWidth>() || h.bit_width != BitWidth || h.limb_count != length) {
+            throw std::runtime_error("mp_int file does not match the requested sign or width: " + path.string());
+        }
+        // 壊れたレコード数で掛け算が溢れないように，ファイルに入る件数と比べる
+        if(h.record_count > (file_.size() - sizeof(h)) / sizeof(value_type)) {
+            throw std::runtime_error("mp_int file is truncated: " + path.string());
+        }
+        size_ = static_cast<std::size_t>(h.record_count);
+    }
+
+    [[nodiscard]]
+    std::size_t size() const noexcept { return size_; }
+    /// @brief 全レコード．ファイルを写像した領域をmp_intの配列として見る．
+    [[nodiscard]]
+    std::span<const value_type> records() const noexcept {
+        return {reinterpret_cast<const value_type*>(file_.data() + sizeof(mp_int_file_header)), size_};
+    }
+    [[nodiscard]]
+    const_mp_int_view<Sign, BitWidth> operator[](std::size_t i) const noexcept {
+        return const_mp_int_view<Sign, BitWidth>(limbs() + i * length);
+    }
+    /// @brief 全レコードの桁．i番目のレコードは[i * length, (i + 1) * length)
+    [[nodiscard]]
+    const std::uint64_t* limbs() const noexcept {
+        return reinterpret_cast<const std::uint64_t*>(file_.data() + sizeof(mp_int_file_header));
+    }
+
+private:
+    detail::mapped_file file_;
+    std::size_t size_ = 0;
+};
+
+/// @brief mp_intのレコードファイルを書く．レコードは内部のバッファに溜め，まとめて書き出す．
+/// レコード数はclose(またはデストラクタ)でヘッダに書き戻す．
+template<sign Sign, unsigned int BitWidth>
+class mp_int_file_writer {
+public:
+    using value_type = mp_int<Sign, BitWidth>;
+    static constexpr unsigned int length = value_type::length;
+
+    /// @param buffer_bytes 一度に書き出すバイト数の目安
+    explicit mp_int_file_writer(const std::filesystem::path& path, std::size_t buffer_bytes = 1 << 20)
+        : path_(path)
+        , file_(std::fopen(path.string().c_str(), "wb"))
+        , count_(0)
+    {
+        if(!file_) detail::throw_file_error("can't open", path_);
+        std::setvbuf(file_, nullptr, _IONBF, 0);
+        buffer_.reserve(std::max<std::size_t>(buffer_bytes / sizeof(std::uint64_t) / length, 1) * length);
+        mp_int_file_header h{};
+        std::memcpy(h.magic, mp_int_file_header::magic_value, sizeof(h.magic));
+        h.version = mp_int_file_header::current_version;
+        h.flags = detail::mp_int_file_flags<Sign, BitWidth>();
+        h.bit_width = BitWidth;
+        h.limb_count = length;
+        try {
+            write_raw(&h, sizeof(h));
+        } catch(...) {
+            std::fclose(std::exchange(file_, nullptr));
+            throw;
+        }
+    }
+    mp_int_file_writer(const mp_int_file_writer&) = delete;
+    mp_int_file_writer& operator=(const mp_int_file_writer&) = delete;
+    ~mp_int_file_writer() {
+        try {
+            close();
+        } catch(...) {
+        }
+    }
+
+    template<detail::expression E>
+    void push(const E& e) {
+        decltype(auto) v = expr_to_mp_int(e);
+        const value_type& x = v;
+        if(buffer_.size() + length > buffer_.capacity()) flush();
+        buffer_.insert(buffer_.end(), x.value_.poly.begin(), x.value_.poly.end());
+        ++count_;
+    }
+    void write(std::span<const value_type> values) {
+        for(const auto& v : values) push(v);
+    }
+    [[nodiscard]]
+    std::size_t size() const noexcept { return count_; }
+
+    /// @brief バッファを書き出す
+    void flush() {
+        write_raw(buffer_.data(), buffer_.size() * sizeof(std::uint64_t));
+        buffer_.clear();
+    }
+    /// @brief バッファを書き出し，ヘッダのレコード数を書き戻して閉じる
+    void close() {
+        if(!file_) return;
+        flush();
+        const std::uint64_t count = count_;
+        if(std::fseek(file_, offsetof(mp_int_file_header, record_count), SEEK_SET) != 0) detail::throw_file_error("can't seek", path_);
+        write_raw(&count, sizeof(count));
+        std::FILE* f = std::exchange(file_, nullptr);
+        if(std::fclose(f) != 0) detail::throw_file_error("can't close", path_);
+    }
+
+private:
+    std::filesystem::path path_;
+    std::FILE* file_;
+    std::size_t count_;
+    std::vector<std::uint64_t> buffer_;
+
+    void write_raw(const void* p, std::size_t bytes) {
+        if(bytes && std::fwrite(p, 1, bytes, file_) != bytes) detail::throw_file_error("can't write", path_);
+    }
+};
+
+/// @brief 空白で区切ったbase進数のテキストファイルをレコードファイルに変換する．
+/// テキストは写像して直接from_charsで読むので，行ごとの文字列は作らない．
+/// 数として読めない文字列や範囲外の値があればstd::invalid_argumentを投げる．
+/// @return 書き出したレコード数
+template<sign Sign, unsigned int BitWidth>
+std::size_t convert_text_to_mp_int_file(const std::filesystem::path& text, const std::filesystem::path& out, int base = 10) {
+    const detail::mapped_file in(text);
+    mp_int_file_writer<Sign, BitWidth> writer(out);
+    const char* p = reinterpret_cast<const char*>(in.data());
+    const char* const last = p + in.size();
+    constexpr auto is_space = [](char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f'; };
+    mp_int<Sign, BitWidth> v = 0;
+    while(true) {
+        while(p != last && is_space(*p)) ++p;
+        if(p == last) break;
+        const auto [next, ec] = from_chars(p, last, v, base);
+        if(ec != std::errc{} || (next != last && !is_space(*next))) {
+            throw std::invalid_argument("invalid number at byte " + std::to_string(p - reinterpret_cast<const char*>(in.data())) + " of " + text.string());
+        }
+        writer.push(v);
+        p = next;
+    }
+    writer.close();
+    return writer.size();
+}
+
+}
@@ -0,0 +1,211 @@
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <iterator>
+#include <mutex>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "mp_int.hpp"
+#include "expression.hpp"
+#include "convertion.hpp"
+
+namespace chao {
+
+/// @brief mp_intや式の列を区切り文字で区切ったテキストとして書き出す．
+/// 値は再利用する大きなバッファにto_charsで直接書き，バッファが埋まったらfwriteでまとめて書き出す．
+/// write_rangeは範囲をブロックに分けて複数のスレッドで変換し，変換と並行して元の順に書き出せる．
+class mp_int_text_writer {
+public:
+    /// @param file 書き出し先．閉じるのは呼び出し側
+    /// @param delimiter 各値の後に書く区切り
+    /// @param buffer_bytes 一度に書き出すバイト数の目安
+    explicit mp_int_text_writer(std::FILE* file, std::string_view delimiter = "\n", int base = 10, std::size_t buffer_bytes = 1 << 20)
+        : file_(file)
+        , owns_(false)
+        , delimiter_(delimiter)
+        , base_(base)
+        , buffer_(std::max<std::size_t>(buffer_bytes, 1))
+        , used_(0)
+    {}
+    explicit mp_int_text_writer(const std::filesystem::path& path, std::string_view delimiter = "\n", int base = 10, std::size_t buffer_bytes = 1 << 20)
+        : mp_int_text_writer(std::fopen(path.string().c_str(), "wb"), delimiter, base, buffer_bytes)
+    {
+        if(!file_) throw std::system_error(errno, std::generic_category(), "can't open: " + path.string());
+        owns_ = true;
+        std::setvbuf(file_, nullptr, _IONBF, 0);
+    }
+    mp_int_text_writer(const mp_int_text_writer&) = delete;
+    mp_int_text_writer& operator=(const mp_int_text_writer&) = delete;
+    ~mp_int_text_writer() {
+        try {
+            close();
+        } catch(...) {
+        }
+    }
+
+    template<detail::derived_expression E>
+    mp_int_text_writer& write(const E& e) {
+        const std::size_t n = value_chars<E>();
+        if(buffer_.size() - used_ < n) {
+            flush();
+            if(buffer_.size() < n) buffer_.resize(n);
+        }
+        used_ = format(buffer_.data() + used_, buffer_.data() + buffer_.size(), e) - buffer_.data();
+        return *this;
+    }
+    /// @brief 範囲の全ての値を書く．threadsが2以上で範囲が大きさの分かるランダムアクセス範囲なら，
+    /// バッファ1つ分ずつのブロックに分けてthreads個のスレッドで変換し，変換と並行して順に書き出す．
+    template<std::ranges::input_range R>
+        requires detail::derived_expression<std::ranges::range_value_t<R>>
+    mp_int_text_writer& write_range(R&& r, unsigned int threads = 1) {
+        using value_t = std::ranges::range_value_t<R>;
+        if constexpr (std::ranges::random_access_range<R> && std::ranges::sized_range<R>) {
+            if(threads > 1) {
+                write_parallel<value_t>(std::ranges::begin(r), std::ranges::size(r), threads);
+                return *this;
+            }
+        }
+        for(auto&& x : r) {
+            const value_t& v = x;
+            write(v);
+        }
+        return *this;
+    }
+
+    /// @brief バッファを書き出す
+    void flush() {
+        write_raw(buffer_.data(), used_);
+        used_ = 0;
+    }
+    /// @brief バッファを書き出し，コンストラクタで開いたファイルなら閉じる
+    void close() {
+        if(!file_) return;
+        flush();
+        std::FILE* f = std::exchange(file_, nullptr);
+        if(owns_ && std::fclose(f) != 0) throw std::system_error(errno, std::generic_category(), "can't close");
+    }
+
+private:
+    std::FILE* file_;
+    bool owns_;
+    std::string delimiter_;
+    int base_;
+    std::vector<char> buffer_;
+    std::size_t used_;
+    /// @brief write_parallelで回すブロックのバッファ
+    std::vector<std::vector<char>> blocks_;
+
+    /// @brief 1つの値と区切りに必要な文字数
+    template<class E>
+    std::size_t value_chars() const noexcept {
+        return detail::max_chars(detail::bit_length_v<E>, base_) + 1 + delimiter_.size();
+    }
+    template<class E>
+    char* format(char* first, char* last, const E& e) const {
+        char* p = to_chars(first, last, e, base_).ptr;
+        return std::copy(delimiter_.begin(), delimiter_.end(), p);
+    }
+    template<class V, class It>
+    void format_block(std::vector<char>& out, It first, std::size_t n) const {
+        out.resize(n * value_chars<V>());
+        char* p = out.data();
+        char* const last = p + out.size();
+        for(std::size_t i = 0; i < n; ++i, ++first) {
+            const V& v = *first;
+            p = format(p, last, v);
+        }
+        out.resize(p - out.data());
+    }
+    /// @brief threads個のスレッドを一度だけ起こし，ブロックを順に取らせて変換させる．
+    /// 呼び出したスレッドは変換の済んだブロックを元の順にfwriteし，その間も他のブロックの変換は進む．
+    /// 各スレッドが書き出し待ちのブロックを1つ抱えたまま次を変換できるように，バッファは2*threads個を回す．
+    template<class V, class It>
+    void write_parallel(It first, std::size_t total, unsigned int threads) {
+        flush();
+        const std::size_t block = std::max<std::size_t>(buffer_.size() / value_chars<V>(), 1);
+        const std::size_t count = (total + block - 1) / block;
+        const std::size_t slots = std::min<std::size_t>(2 * threads, count);
+        if(slots == 0) return;
+        blocks_.resize(slots);
+        std::mutex mutex;
+        std::condition_variable cv;
+        // ready[s]: スロットsで変換を終えたブロックの番号 + 1
+        std::vector<std::size_t> ready(slots, 0);
+        std::size_t next = 0, written = 0;
+        bool stop = false;
+        std::exception_ptr error;
+        const auto fail = [&](std::exception_ptr e) {
+            if(!error) error = e;
+            stop = true;
+            cv.notify_all();
+        };
+        const auto worker = [&] {
+            std::unique_lock lock(mutex);
+            for(;;) {
+                cv.wait(lock, [&] { return stop || next >= count || next < written + slots; });
+                if(stop || next >= count) return;
+                const std::size_t i = next++;
+                lock.unlock();
+                try {
+                    const std::size_t b = i * block;
+                    format_block<V>(blocks_[i % slots], first + static_cast<std::iter_difference_t<It>>(b), std::min(block, total - b));
+                } catch(...) {
+                    lock.lock();
+                    fail(std::current_exception());
+                    return;
+                }
+                lock.lock();
+                ready[i % slots] = i + 1;
+                cv.notify_all();
+            }
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        try {
+            for(auto t = 0u; t < threads && t < count; ++t) workers.emplace_back(worker);
+            std::unique_lock lock(mutex);
+            for(std::size_t i = 0; i < count && !stop; ++i) {
+                cv.wait(lock, [&] { return stop || ready[i % slots] == i + 1; });
+                if(stop) break;
+                lock.unlock();
+                const auto& out = blocks_[i % slots];
+                try {
+                    write_raw(out.data(), out.size());
+                } catch(...) {
+                    lock.lock();
+                    fail(std::current_exception());
+                    break;
+                }
+                lock.lock();
+                ++written;
+                cv.notify_all();
+            }
+        } catch(...) {
+            std::lock_guard lock(mutex);
+            fail(std::current_exception());
+        }
+        {
+            std::lock_guard lock(mutex);
+            stop = true;
+        }
+        cv.notify_all();
+        for(auto& w : workers) w.join();
+        if(error) std::rethrow_exception(error);
+    }
+    void write_raw(const char* p, std::size_t bytes) {
+        if(bytes && std::fwrite(p, 1, bytes, file_) != bytes) throw std::system_error(errno, std::generic_category(), "can't write");
+    }
+};
+
+}
@@ -0,0 +1,414 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "mp_int.hpp"
+#include "expression.hpp"
+#include "operators.hpp"
+
+namespace chao {
+
+/// @brief mp_intの配列を桁ごとに分けて(structure of arrays)保持するコンテナ．
+/// i桁目の値はlimb_data(i)から連続して並んでいるので，要素をまたいで同じ桁を一度に処理できる．
+/// 要素へのアクセスはプロキシ参照を通す．プロキシ参照は式の被演算子になり，評価のときに各桁の配列から値を集める．
+template<sign Sign, unsigned int BitWidth, class Allocator = std::allocator<std::uint64_t>>
+class mp_int_vector {
+public:
+    using value_type = mp_int<Sign, BitWidth>;
+    using int_type = detail::impl_base::int_type;
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+    static constexpr unsigned int length = value_type::length;
+
+    class const_reference : public detail::expression_base {
+        friend class mp_int_vector;
+    public:
+        static constexpr unsigned int bit_length = value_type::bit_length;
+        static constexpr unsigned int length = value_type::length;
+        static constexpr sign sign_value = Sign;
+
+        template<detail::limb_destination D>
+        void evaluate(D& dest) const noexcept {
+            int_type t[length];
+            v_->gather(j_, t);
+            detail::copy_limbs<D::sign_value, BitWidth>(dest.data(), D::length, t);
+            dest.normalize();
+        }
+        [[nodiscard]]
+        value_type evaluate() const noexcept { return get(); }
+        [[nodiscard]]
+        value_type get() const noexcept {
+            value_type r;
+            v_->gather(j_, r.data());
+            return r;
+        }
+    private:
+        const mp_int_vector* v_;
+        size_type j_;
+        const_reference(const mp_int_vector* v, size_type j) noexcept : v_(v), j_(j) {}
+    };
+    class reference : public detail::expression_base {
+        friend class mp_int_vector;
+    public:
+        static constexpr unsigned int bit_length = value_type::bit_length;
+        static constexpr unsigned int length = value_type::length;
+        static constexpr sign sign_value = Sign;
+
+        reference(const reference&) = default;
+        template<detail::limb_destination D>
+        void evaluate(D& dest) const noexcept {
+            const_reference(v_, j_).evaluate(dest);
+        }
+        [[nodiscard]]
+        value_type evaluate() const noexcept { return get(); }
+        [[nodiscard]]
+        value_type get() const noexcept {
+            return const_reference(v_, j_).get();
+        }
+        reference& operator=(const value_type& x) noexcept {
+            for(auto i = 0u; i < length; ++i) v_->limbs_[i][j_] = x.value_.poly[i];
+            return *this;
+        }
+        reference& operator=(const reference& x) noexcept {
+            return *this = x.get();
+        }
+        template<detail::expression E>
+        reference& operator=(const E& e) noexcept {
+            return *this = value_type(e);
+        }
+        template<detail::expression E>
+        reference& operator+=(const E& e) noexcept { return *this = *this + e; }
+        template<detail::expression E>
+        reference& operator-=(const E& e) noexcept { return *this = *this - e; }
+        template<detail::expression E>
+        reference& operator*=(const E& e) noexcept { return *this = *this * e; }
+        template<detail::expression E>
+        reference& operator/=(const E& e) noexcept { return *this = *this / e; }
+        template<detail::expression E>
+        reference& operator%=(const E& e) noexcept { return *this = *this % e; }
+        template<detail::expression E>
+        reference& operator&=(const E& e) noexcept { return *this = *this & e; }
+        template<detail::expression E>
+        reference& operator|=(const E& e) noexcept { return *this = *this | e; }
+        template<detail::expression E>
+        reference& operator^=(const E& e) noexcept { return *this = *this ^ e; }
+        template<detail::expression E>
+        reference& operator<<=(const E& e) noexcept { return *this = *this << e; }
+        template<detail::expression E>
+        reference& operator>>=(const E& e) noexcept { return *this = *this >> e; }
+    private:
+        mp_int_vector* v_;
+        size_type j_;
+        reference(mp_int_vector* v, size_type j) noexcept : v_(v), j_(j) {}
+    };
+
+    /// @brief 添字で要素を指すイテレータ
+    template<bool Const>
+    class basic_iterator {
+        using owner_t = std::conditional_t<Const, const mp_int_vector, mp_int_vector>;
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = mp_int_vector::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, mp_int_vector::const_reference, mp_int_vector::reference>;
+
+        basic_iterator() noexcept = default;
+        basic_iterator(owner_t* v, size_type j) noexcept : v_(v), j_(j) {}
+        reference operator*() const noexcept { return (*v_)[j_]; }
+        reference operator[](difference_type n) const noexcept { return (*v_)[j_ + n]; }
+        basic_iterator& operator++() noexcept { ++j_; return *this; }
+        basic_iterator operator++(int) noexcept { auto cp = *this; ++j_; return cp; }
+        basic_iterator& operator--() noexcept { --j_; return *this; }
+        basic_iterator operator--(int) noexcept { auto cp = *this; --j_; return cp; }
+        basic_iterator& operator+=(difference_type n) noexcept { j_ += n; return *this; }
+        basic_iterator& operator-=(difference_type n) noexcept { j_ -= n; return *this; }
+        friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept { return it += n; }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept { return it -= n; }
+        friend difference_type operator-(const basic_iterator& a, const basic_iterator& b) noexcept { return (difference_type)a.j_ - (difference_type)b.j_; }
+        friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept { return a.j_ == b.j_; }
+        friend auto operator<=>(const basic_iterator& a, const basic_iterator& b) noexcept { return a.j_ <=> b.j_; }
+    private:
+        owner_t* v_ = nullptr;
+        size_type j_ = 0;
+    };
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    mp_int_vector() = default;
+    explicit mp_int_vector(const Allocator& alloc)
+        : limbs_(make_planes(alloc))
+        , scratch_(alloc)
+    {}
+    explicit mp_int_vector(size_type n, const value_type& x = value_type(0), const Allocator& alloc = Allocator())
+        : mp_int_vector(alloc)
+    {
+        resize(n, x);
+    }
+    mp_int_vector(std::initializer_list<value_type> il, const Allocator& alloc = Allocator())
+        : mp_int_vector(std::span<const value_type>(il.begin(), il.size()), alloc)
+    {}
+    /// @brief mp_intの配列(array of structures)から変換する
+    explicit mp_int_vector(std::span<const value_type> aos, const Allocator& alloc = Allocator())
+        : mp_int_vector(alloc)
+    {
+        assign(aos);
+    }
+
+    [[nodiscard]]
+    reference operator[](size_type j) noexcept { return reference(this, j); }
+    [[nodiscard]]
+    const_reference operator[](size_type j) const noexcept { return const_reference(this, j); }
+    [[nodiscard]]
+    reference at(size_type j) {
+        if(j >= size()) throw std::out_of_range("mp_int_vector::at" + ERR_PLACE);
+        return (*this)[j];
+    }
+    [[nodiscard]]
+    const_reference at(size_type j) const {
+        if(j >= size()) throw std::out_of_range("mp_int_vector::at" + ERR_PLACE);
+        return (*this)[j];
+    }
+    iterator begin() noexcept { return iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, size()); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size()); }
+
+    [[nodiscard]]
+    size_type size() const noexcept { return limbs_[0].size(); }
+    [[nodiscard]]
+    bool empty() const noexcept { return limbs_[0].empty(); }
+    [[nodiscard]]
+    allocator_type get_allocator() const noexcept { return limbs_[0].get_allocator(); }
+    /// @brief i桁目を要素の順に並べた配列
+    [[nodiscard]]
+    int_type* limb_data(unsigned int i) noexcept { return limbs_[i].data(); }
+    [[nodiscard]]
+    const int_type* limb_data(unsigned int i) const noexcept { return limbs_[i].data(); }
+
+    void reserve(size_type n) {
+        for(auto& p : limbs_) p.reserve(n);
+    }
+    void resize(size_type n, const value_type& x = value_type(0)) {
+        for(auto i = 0u; i < length; ++i) limbs_[i].resize(n, x.value_.poly[i]);
+    }
+    void clear() noexcept {
+        for(auto& p : limbs_) p.clear();
+    }
+    void push_back(const value_type& x) {
+        for(auto i = 0u; i < length; ++i) limbs_[i].push_back(x.value_.poly[i]);
+    }
+    void pop_back() noexcept {
+        for(auto& p : limbs_) p.pop_back();
+    }
+
+    /// @brief mp_intの配列(array of structures)の内容で置き換える
+    void assign(std::span<const value_type> aos) {
+        resize(aos.size());
+        // 出力の各桁の配列へは連続して書き込まれる
+        for(size_type j = 0; j < aos.size(); ++j) {
+            for(auto i = 0u; i < length; ++i) limbs_[i][j] = aos[j].value_.poly[i];
+        }
+    }
+    /// @brief mp_intの配列(array of structures)に書き出す．outはsize()個の要素を持つこと．
+    void copy_to(std::span<value_type> out) const noexcept {
+        for(size_type j = 0; j < out.size(); ++j) {
+            for(auto i = 0u; i < length; ++i) out[j].value_.poly[i] = limbs_[i][j];
+        }
+    }
+    [[nodiscard]]
+    std::vector<value_type> to_aos() const {
+        std::vector<value_type> r(size());
+        copy_to(r);
+        return r;
+    }
+
+    /// @brief 要素ごとに f(out, in...) を呼んで結果を書き込む．
+    /// 要素ごとに桁を集めてmp_intとして計算し，結果を各桁の配列へ書き戻す．
+    /// 加減算，ビット演算，シフト，整数倍は桁ごとに全要素をまとめて処理する複合代入演算子を使う方が速い．
+    /// 例: c.transform([](auto& r, const auto& x, const auto& y) { r = x * y + 1; }, a, b);
+    template<class F, class ...Vs>
+    mp_int_vector& transform(F&& f, const Vs& ...vs) {
+        const size_type n = std::min({vs.size()...});
+        resize(n);
+        for(size_type j = 0; j < n; ++j) {
+            value_type r;
+            f(r, vs[j].get()...);
+            (*this)[j] = r;
+        }
+        return *this;
+    }
+
+    /// @brief 要素ごとの加算．桁ごとに全要素をまとめて処理し，桁上がりは要素ごとに持ち回る．
+    mp_int_vector& operator+=(const mp_int_vector& o) { return add_sub<false>(o); }
+    mp_int_vector& operator-=(const mp_int_vector& o) { return add_sub<true>(o); }
+    mp_int_vector& operator&=(const mp_int_vector& o) noexcept { return bitwise(o, std::bit_and<>{}); }
+    mp_int_vector& operator|=(const mp_int_vector& o) noexcept { return bitwise(o, std::bit_or<>{}); }
+    mp_int_vector& operator^=(const mp_int_vector& o) noexcept { return bitwise(o, std::bit_xor<>{}); }
+    /// @brief 全要素にmを掛ける．桁ごとに全要素をまとめて処理し，上位への桁は要素ごとに持ち回る．
+    template<std::integral T>
+    mp_int_vector& operator*=(T m) {
+        const bool negative = std::is_signed_v<T> && m < 0;
+        mul_1(negative ? (int_type)0 - (int_type)m : (int_type)m);
+        if(negative) negate();
+        return *this;
+    }
+    /// @brief 全要素を左へsビットずらす．出力の桁ごとに，元の2つの桁の配列から全要素をまとめて作る．
+    mp_int_vector& operator<<=(unsigned int s) noexcept {
+        const size_type n = size();
+        const unsigned int q = s / 64, r = s % 64;
+        for(auto i = length; i-- > 0;) {
+            int_type* d = limbs_[i].data();
+            if(i < q) {
+                std::fill_n(d, n, 0);
+            } else if(r == 0) {
+                if(q) std::copy_n(limbs_[i - q].data(), n, d);
+            } else if(i == q) {
+                const int_type* lo = limbs_[0].data();
+                for(size_type j = 0; j < n; ++j) d[j] = lo[j] << r;
+            } else {
+                const int_type* hi = limbs_[i - q].data();
+                const int_type* lo = limbs_[i - q - 1].data();
+                for(size_type j = 0; j < n; ++j) d[j] = (hi[j] << r) | (lo[j] >> (64 - r));
+            }
+        }
+        normalize_top(n);
+        return *this;
+    }
+    /// @brief 全要素を右へsビットずらす．符号付きなら算術シフトになる．
+    mp_int_vector& operator>>=(unsigned int s) noexcept {
+        const size_type n = size();
+        const unsigned int q = s / 64, r = s % 64;
+        const int_type* top = limbs_[length - 1].data();
+        // 最上位桁の余りのビットは揃っているので，その最上位ビットが要素の符号になる
+        const auto fill = [top](size_type j) noexcept {
+            return Sign == sign::mp_signed ? (int_type)((std::int64_t)top[j] >> 63) : 0;
+        };
+        for(auto i = 0u; i < length; ++i) {
+            int_type* d = limbs_[i].data();
+            if(q >= length - i) {
+                for(size_type j = 0; j < n; ++j) d[j] = fill(j);
+            } else if(r == 0) {
+                if(q) std::copy_n(limbs_[i + q].data(), n, d);
+            } else if(q == length - i - 1) {
+                const int_type* lo = limbs_[i + q].data();
+                for(size_type j = 0; j < n; ++j) d[j] = (lo[j] >> r) | (fill(j) << (64 - r));
+            } else {
+                const int_type* lo = limbs_[i + q].data();
+                const int_type* hi = limbs_[i + q + 1].data();
+                for(size_type j = 0; j < n; ++j) d[j] = (lo[j] >> r) | (hi[j] << (64 - r));
+            }
+        }
+        normalize_top(n);
+        return *this;
+    }
+
+private:
+    using plane = std::vector<int_type, Allocator>;
+    /// @brief 要素ごとの桁上がりを置く作業領域．コンテナのアロケータで確保し，呼び出しをまたいで使い回す．
+    /// コピーでは中身を引き継がない．
+    class scratch_plane {
+    public:
+        scratch_plane() = default;
+        explicit scratch_plane(const Allocator& alloc) : buf_(alloc) {}
+        scratch_plane(const scratch_plane& o) : buf_(o.buf_.get_allocator()) {}
+        scratch_plane(scratch_plane&&) noexcept = default;
+        scratch_plane& operator=(const scratch_plane&) noexcept { return *this; }
+        scratch_plane& operator=(scratch_plane&&) noexcept { return *this; }
+        /// @brief 0で埋めたn個の領域
+        int_type* zeroed(size_type n) {
+            buf_.assign(n, 0);
+            return buf_.data();
+        }
+    private:
+        plane buf_;
+    };
+    std::array<plane, length> limbs_;
+    scratch_plane scratch_;
+
+    static std::array<plane, length> make_planes(const Allocator& alloc) {
+        return [&]<std::size_t ...I>(std::index_sequence<I...>) {
+            return std::array<plane, length>{((void)I, plane(alloc))...};
+        }(std::make_index_sequence<length>{});
+    }
+
+    /// @brief j番目の要素の桁をoutに集める
+    void gather(size_type j, int_type* out) const noexcept {
+        for(auto i = 0u; i < length; ++i) out[i] = limbs_[i][j];
+    }
+
+    template<bool Sub>
+    mp_int_vector& add_sub(const mp_int_vector& o) {
+        const size_type n = std::min(size(), o.size());
+        // 要素ごとの桁上がりを別の配列に持ち，内側のループを要素方向にしてベクトル化させる
+        int_type* carry = scratch_.zeroed(n);
+        for(auto i = 0u; i < length; ++i) {
+            int_type* d = limbs_[i].data();
+            const int_type* s = o.limbs_[i].data();
+            for(size_type j = 0; j < n; ++j) {
+                if constexpr (Sub) carry[j] = detail::impl_base::subb((unsigned char)carry[j], d[j], s[j], d[j]);
+                else carry[j] = detail::impl_base::addc((unsigned char)carry[j], d[j], s[j], d[j]);
+            }
+        }
+        normalize_top(n);
+        return *this;
+    }
+    /// @brief 全要素にmを掛ける．要素ごとの上位の桁を別の配列に持ち，下の桁から順に処理する．
+    void mul_1(int_type m) {
+        const size_type n = size();
+        int_type* carry = scratch_.zeroed(n);
+        for(auto i = 0u; i < length; ++i) {
+            int_type* d = limbs_[i].data();
+            for(size_type j = 0; j < n; ++j) {
+                int_type lo;
+                const int_type hi = detail::naive_mul::mul(lo, d[j], m);
+                carry[j] = hi + detail::impl_base::addc(0, lo, carry[j], d[j]);
+            }
+        }
+        normalize_top(n);
+    }
+    /// @brief 全要素の符号を反転する(2の補数)
+    void negate() {
+        const size_type n = size();
+        int_type* borrow = scratch_.zeroed(n);
+        for(auto i = 0u; i < length; ++i) {
+            int_type* d = limbs_[i].data();
+            for(size_type j = 0; j < n; ++j) borrow[j] = detail::impl_base::subb((unsigned char)borrow[j], 0, d[j], d[j]);
+        }
+        normalize_top(n);
+    }
+    template<class Op>
+    mp_int_vector& bitwise(const mp_int_vector& o, Op op) noexcept {
+        const size_type n = std::min(size(), o.size());
+        for(auto i = 0u; i < length; ++i) {
+            int_type* d = limbs_[i].data();
+            const int_type* s = o.limbs_[i].data();
+            for(size_type j = 0; j < n; ++j) d[j] = op(d[j], s[j]);
+        }
+        return *this;
+    }
+    /// @brief 最上位桁の余りのビットを揃える
+    void normalize_top(size_type n) noexcept {
+        if constexpr (value_type::spare_bits != 0) {
+            constexpr unsigned int spare = value_type::spare_bits;
+            int_type* d = limbs_[length - 1].data();
+            for(size_type j = 0; j < n; ++j) {
+                if constexpr (Sign == sign::mp_signed) d[j] = (int_type)((std::int64_t)(d[j] << spare) >> spare);
+                else d[j] &= ~(int_type)0 >> spare;
+            }
+        }
+    }
+};
+
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+#include "detail/common.hpp"
+#include "detail/opimpl.hpp"
+#include "mp_int.hpp"
+#include "expression.hpp"
+#include "operators.hpp"
+
+namespace chao {
+
+namespace detail {
+
+/// @brief 外部が所有するリトルエンディアンの64ビットの桁の列をmp_intとして参照する．
+/// 被演算子としては桁をポインタから直接読み，mp_int_viewへの代入では式の結果を参照先の桁に直接書く．
+/// 代入先が被演算子と同じ桁を指す掛け算と割り算だけは一時領域で計算してから書き戻す．
+/// @tparam Limb std::uint64_tまたはそのconst
+template<sign Sign, unsigned int BitWidth, class Limb>
+class basic_mp_int_view : public expression_base {
+public:
+    using int_type = impl_base::int_type;
+    using coeff_type = int_type;
+    static constexpr unsigned int bit_length = int_representation<BitWidth>::bit_length;
+    static constexpr unsigned int length = int_representation<BitWidth>::length;
+    static constexpr unsigned int size = int_representation<BitWidth>::size;
+    static constexpr unsigned int spare_bits = int_representation<BitWidth>::spare_bits;
+    static constexpr sign sign_value = Sign;
+
+    template<limb_destination D>
+    constexpr void evaluate(D& dest) const noexcept {
+        if(dest.data() != limbs_) copy_limbs<D::sign_value, BitWidth>(dest.data(), D::length, limbs_);
+        dest.normalize();
+    }
+    [[nodiscard]]
+    constexpr mp_int<Sign, BitWidth> evaluate() const noexcept {
+        mp_int<Sign, BitWidth> r;
+        std::copy(limbs_, limbs_ + length, r.value_.poly.begin());
+        r.normalize();
+        return r;
+    }
+    constexpr auto limb_loader() const noexcept {
+        return static_limb_loader<length>{{limbs_, length, extension_fill<Sign>(msb())}};
+    }
+    [[nodiscard]]
+    constexpr Limb* data() const noexcept { return limbs_; }
+
+    template<expression E>
+    constexpr std::strong_ordering operator<=>(const E& e) const noexcept {
+        const auto o = make_operand_limbs<0, Sign>(e);
+        constexpr sign S = Sign & sign_v<std::remove_cvref_t<E>>;
+        return impl_base::cmp<S, length, decltype(o)::length>(limbs_, o.data()) <=> 0;
+    }
+    template<expression E>
+    constexpr bool operator==(const E& e) const noexcept {
+        return (*this <=> e) == std::strong_ordering::equal;
+    }
+    [[nodiscard]]
+    constexpr explicit operator bool() const noexcept {
+        return std::any_of(limbs_, limbs_ + length, [](int_type x) { return x != 0; });
+    }
+
+protected:
+    Limb* limbs_;
+
+    constexpr explicit basic_mp_int_view(Limb* limbs) noexcept
+        : limbs_(limbs)
+    {}
+    constexpr bool msb() const noexcept {
+        return (limbs_[length - 1] >> ((bit_length - 1) % 64)) & 1;
+    }
+};
+
+}
+
+/// @brief 読み取り専用のmp_int_view
+template<sign Sign, unsigned int BitWidth>
+class const_mp_int_view : public detail::basic_mp_int_view<Sign, BitWidth, const std::uint64_t> {
+    using base = detail::basic_mp_int_view<Sign, BitWidth, const std::uint64_t>;
+public:
+    /// @param limbs length個の桁．最上位桁の余りのビットは揃っていること
+    constexpr explicit const_mp_int_view(const std::uint64_t* limbs) noexcept
+        : base(limbs)
+    {}
+    constexpr const_mp_int_view(const mp_int<Sign, BitWidth>& v) noexcept
+        : base(v.value_.poly.data())
+    {}
+    constexpr const_mp_int_view(const const_mp_int_view&) noexcept = default;
+    const_mp_int_view& operator=(const const_mp_int_view&) = delete;
+};
+
+/// @brief 外部の桁の列を読み書きするmp_int_view．
+/// 代入は参照先を付け替えずに参照先の値を書き換える．
+template<sign Sign, unsigned int BitWidth>
+class mp_int_view : public detail::basic_mp_int_view<Sign, BitWidth, std::uint64_t> {
+    using base = detail::basic_mp_int_view<Sign, BitWidth, std::uint64_t>;
+public:
+    /// @param limbs length個の桁
+    constexpr explicit mp_int_view(std::uint64_t* limbs) noexcept
+        : base(limbs)
+    {}
+    constexpr mp_int_view(mp_int<Sign, BitWidth>& v) noexcept
+        : base(v.value_.poly.data())
+    {}
+    constexpr mp_int_view(const mp_int_view&) noexcept = default;
+
+    constexpr mp_int_view& operator=(const mp_int_view& other) noexcept {
+        if(other.limbs_ != this->limbs_) std::copy_n(other.limbs_, base::length, this->limbs_);
+        return *this;
+    }
+    /// @brief 式の結果を参照先の桁に直接書く
+    template<detail::derived_expression E>
+    constexpr mp_int_view& operator=(const E& e) noexcept {
+        if constexpr (detail::limb_sequence<E>) {
+            // mp_intの代入と同じく代入元の符号で拡張する
+            if(e.data() != this->limbs_) detail::copy_limbs<E::sign_value, E::bit_length>(this->limbs_, base::length, e.data());
+            normalize();
+        } else {
+            e.evaluate(*this);
+        }
+        return *this;
+    }
+    template<std::integral T>
+    constexpr mp_int_view& operator=(T i) noexcept {
+        this->limbs_[0] = static_cast<std::uint64_t>(i);
+        std::fill_n(this->limbs_ + 1, base::length - 1, (std::is_signed_v<T> && i < 0) ? ~0ull : 0);
+        normalize();
+        return *this;
+    }
+    [[nodiscard]]
+    constexpr operator const_mp_int_view<Sign, BitWidth>() const noexcept {
+        return const_mp_int_view<Sign, BitWidth>(this->limbs_);
+    }
+
+    template<detail::expression E>
+    constexpr mp_int_view& operator+=(const E& e) noexcept { return *this = *this + e; }
+    template<detail::expression E>
+    constexpr mp_int_view& operator-=(const E& e) noexcept { return *this = *this - e; }
+    template<detail::expression E>
+    constexpr mp_int_view& operator*=(const E& e) noexcept { return *this = *this * e; }
+    template<detail::expression E>
+    constexpr mp_int_view& operator/=(const E& e) noexcept { return *this = *this / e; }
+    template<detail::expression E>
+    constexpr mp_int_view& operator%=(const E& e) noexcept { return *this = *this % e; }
+    template<detail::expression E>
+    constexpr mp_int_view& operator&=(const E& e) noexcept { return *this = *this & e; }
+    template<detail::expression E>
+    constexpr mp_int_view& operator|=(const E& e) noexcept { return *this = *this | e; }
+    template<detail::expression E>
+    constexpr mp_int_view& operator^=(const E& e) noexcept { return *this = *this ^ e; }
+    template<detail::expression E>
+    constexpr mp_int_view& operator<<=(const E& e) noexcept { return *this = *this << e; }
+    template<detail::expression E>
+    constexpr mp_int_view& operator>>=(const E& e) noexcept { return *this = *this >> e; }
+
+    /// @brief 最上位桁の余りのビットを値の符号に合わせて揃える
+    constexpr void normalize() noexcept {
+        detail::normalize_limbs<Sign, BitWidth>(this->limbs_);
+    }
+};
+
+}
@@ -1,9 +1,44 @@
 #pragma once
+#include <cassert>
+#include <functional>
+#include <type_traits>
+
 #include "mp_int.hpp"
 #include "expression.hpp"
 
 namespace chao{
 
+namespace detail {
+
+/// @brief eをBitWidthビットの被演算子として取り出す．
+/// 変換が要らなければ参照をそのまま返し，必要な場合だけ一時オブジェクトを作る．
+/// @tparam AllowNarrow 符号なしで短い被演算子をそのまま返してよいか
+template<unsigned int BitWidth, bool AllowNarrow, class E>
+constexpr decltype(auto) operand_of_width(const E& e) noexcept {
+    decltype(auto) v = expr_to_mp_int(e);
+    using v_t = std::remove_cvref_t<decltype(v)>;
+    if constexpr (v_t::bit_length == BitWidth || (AllowNarrow && v_t::bit_length < BitWidth && v_t::sign_value == sign::mp_unsigned)) {
+        return v;
+    } else {
+        mp_int<v_t::sign_value, BitWidth> r;
+        r.value_.template cpy<v_t::sign_value>(v.value_);
+        return r;
+    }
+}
+
+template<sign Sign, unsigned int BitWidth, class Op, class E>
+constexpr void bitwise_assign(mp_int<Sign, BitWidth>& dest, const E& e) noexcept {
+    using self_loader = static_limb_loader<mp_int<Sign, BitWidth>::length>;
+    using e_loader = decltype(make_limb_loader(e));
+    const bitwise_limb_loader<Op, self_loader, e_loader> l{
+        self_loader{{dest.value_.poly.data(), dest.length, extension_fill<Sign>(dest.value_.msb())}},
+        make_limb_loader(e)
+    };
+    fused_bitwise_evaluate(dest.value_, l);
+}
+
+}
+
 /***** BIT OPERATORS *****/
 
 template<detail::expression L, detail::expression R>
@@ -13,7 +48,9 @@ constexpr or_expr<L, R> operator|(const L& lhs, const R& rhs) {
 template<sign Sign, unsigned int BitWidth>
 template<detail::expression T>
 constexpr mp_int<Sign, BitWidth>& mp_int<Sign, BitWidth>::operator|=(T&& e) & noexcept {
-    return *this = *this | e;
+    detail::bitwise_assign<Sign, BitWidth, std::bit_or<>>(*this, e);
+    normalize();
+    return *this;
 }
 
 template<detail::expression L, detail::expression R>
@@ -23,7 +60,9 @@ constexpr and_expr<L, R> operator&(const L& lhs, const R& rhs) {
 template<sign Sign, unsigned int BitWidth>
 template<detail::expression T>
 constexpr mp_int<Sign, BitWidth>& mp_int<Sign, BitWidth>::operator&=(T&& e) & noexcept {
-    return *this = *this & e;
+    detail::bitwise_assign<Sign, BitWidth, std::bit_and<>>(*this, e);
+    normalize();
+    return *this;
 }
 
 template<detail::expression L, detail::expression R>
@@ -33,27 +72,45 @@ constexpr xor_expr<L, R> operator^(const L& lhs, const R& rhs) {
 template<sign Sign, unsigned int BitWidth>
 template<detail::expression T>
 constexpr mp_int<Sign, BitWidth>& mp_int<Sign, BitWidth>::operator^=(T&& e) & noexcept {
-    return *this = *this ^ e;
+    detail::bitwise_assign<Sign, BitWidth, std::bit_xor<>>(*this, e);
+    normalize();
+    return *this;
 }
 
 template<detail::expression L, detail::expression R>
 constexpr shiftr_expr<L, R> operator>>(const L& lhs, const R& rhs) {
     return shiftr_expr<L, R>(lhs, rhs);
 }
+template<detail::expression L, std::integral T, T W>
+constexpr shiftr_expr<L, std::integral_constant<T, W>> operator>>(const L& lhs, std::integral_constant<T, W> rhs) {
+    return shiftr_expr<L, std::integral_constant<T, W>>(lhs, rhs);
+}
 template<sign Sign, unsigned int BitWidth>
 template<detail::expression T>
 constexpr mp_int<Sign, BitWidth>& mp_int<Sign, BitWidth>::operator>>=(T&& e) & noexcept {
-    return *this = *this >> e;
+    decltype(auto) w = expr_to_mp_int(e);
+    assert(w.value_.msb() == false);
+    detail::bitop::shiftr<Sign>(value_, (unsigned int)w.value_.poly[0]);
+    normalize();
+    return *this;
 }
 
 template<detail::expression L, detail::expression R>
 constexpr shiftl_expr<L, R> operator<<(const L& lhs, const R& rhs) {
     return shiftl_expr<L, R>(lhs, rhs);
 }
+template<detail::expression L, std::integral T, T W>
+constexpr shiftl_expr<L, std::integral_constant<T, W>> operator<<(const L& lhs, std::integral_constant<T, W> rhs) {
+    return shiftl_expr<L, std::integral_constant<T, W>>(lhs, rhs);
+}
 template<sign Sign, unsigned int BitWidth>
 template<detail::expression T>
 constexpr mp_int<Sign, BitWidth>& mp_int<Sign, BitWidth>::operator<<=(T&& e) & noexcept {
-    return *this = *this << e;
+    decltype(auto) w = expr_to_mp_int(e);
+    assert(w.value_.msb() == false);
+    detail::bitop::shiftl(value_, (unsigned int)w.value_.poly[0]);
+    normalize();
+    return *this;
 }
 
 /***** ARITHMETIC OPERATORS *****/
@@ -65,7 +122,21 @@ constexpr add_expr<L, R> operator+(const L& lhs, const R& rhs) {
 template<sign Sign, unsigned int BitWidth>
 template<detail::expression T>
 constexpr mp_int<Sign, BitWidth>& mp_int<Sign, BitWidth>::operator+=(T&& e) & noexcept {
-    return *this = *this + e;
+    using e_t = std::remove_cvref_t<T>;
+    if constexpr (std::is_integral_v<e_t>) {
+        if (std::is_signed_v<e_t> && e < 0) detail::impl_base::minus(value_, (coeff_type)0 - (coeff_type)e);
+        else detail::impl_base::plus(value_, (coeff_type)e);
+    } else {
+        decltype(auto) v = expr_to_mp_int(e);
+        using v_t = std::remove_cvref_t<decltype(v)>;
+        if constexpr (v_t::bit_length <= BitWidth) {
+            detail::impl_base::plus_ext<v_t::sign_value>(value_, v.value_);
+        } else {
+            detail::impl_base::add_n(value_.poly.data(), v.value_.poly.data(), length);
+        }
+    }
+    normalize();
+    return *this;
 }
 
 template<detail::expression L, detail::expression R>
@@ -75,7 +146,21 @@ constexpr sub_expr<L, R> operator-(const L& lhs, const R& rhs) {
 template<sign Sign, unsigned int BitWidth>
 template<detail::expression T>
 constexpr mp_int<Sign, BitWidth>& mp_int<Sign, BitWidth>::operator-=(T&& e) & noexcept {
-    return *this = *this - e;
+    using e_t = std::remove_cvref_t<T>;
+    if constexpr (std::is_integral_v<e_t>) {
+        if (std::is_signed_v<e_t> && e < 0) detail::impl_base::plus(value_, (coeff_type)0 - (coeff_type)e);
+        else detail::impl_base::minus(value_, (coeff_type)e);
+    } else {
+        decltype(auto) v = expr_to_mp_int(e);
+        using v_t = std::remove_cvref_t<decltype(v)>;
+        if constexpr (v_t::bit_length <= BitWidth) {
+            detail::impl_base::minus_ext<v_t::sign_value>(value_, v.value_);
+        } else {
+            detail::impl_base::sub_n(value_.poly.data(), v.value_.poly.data(), length);
+        }
+    }
+    normalize();
+    return *this;
 }
 
 template<detail::expression L, detail::expression R>
@@ -85,9 +170,23 @@ constexpr mul_expr<L, R> operator*(const L& lhs, const R& rhs) {
 template<sign Sign, unsigned int BitWidth>
 template<detail::expression T>
 constexpr mp_int<Sign, BitWidth>& mp_int<Sign, BitWidth>::operator*=(T&& e) & noexcept {
-    mp_int<Sign, BitWidth> tmp = *this;
-    mp_int<Sign, BitWidth> etmp(e);
-    return *this = tmp * etmp;
+    using e_t = std::remove_cvref_t<T>;
+    if constexpr (std::is_integral_v<e_t>) {
+        const bool negative = std::is_signed_v<e_t> && e < 0;
+        detail::naive_mul::mul_1(value_, negative ? (coeff_type)0 - (coeff_type)e : (coeff_type)e);
+        if (negative) detail::impl_base::negate(value_);
+    } else {
+        // 乗算はその場では計算できないので被乗数だけ退避する
+        const mp_int tmp = *this;
+        decltype(auto) v = detail::operand_of_width<BitWidth, true>(e);
+        if constexpr (std::remove_cvref_t<decltype(v)>::bit_length == BitWidth) {
+            detail::karatsuba::mul(value_, tmp.value_, detail::same_object(v, *this) ? tmp.value_ : v.value_);
+        } else {
+            detail::karatsuba::mul(value_, tmp.value_, v.value_);
+        }
+    }
+    normalize();
+    return *this;
 }
 
 template<detail::expression L, detail::expression R>
@@ -97,9 +196,14 @@ constexpr div_expr<L, R> operator/(const L& lhs, const R& rhs) {
 template<sign Sign, unsigned int BitWidth>
 template<detail::expression T>
 constexpr mp_int<Sign, BitWidth>& mp_int<Sign, BitWidth>::operator/=(T&& e) & noexcept {
-    mp_int<Sign, BitWidth> tmp = *this;
-    mp_int<Sign, BitWidth> etmp(e);
-    return *this = tmp / etmp;
+    // 除算はその場では計算できないので被除数と剰余の領域だけ用意する
+    const mp_int dividend = *this;
+    mp_int rem;
+    decltype(auto) v = detail::operand_of_width<BitWidth, false>(e);
+    const auto& divisor = detail::same_object(v, *this) ? dividend.value_ : v.value_;
+    detail::naive_mul::div<Sign, BitWidth>(value_, rem.value_, dividend.value_, divisor);
+    normalize();
+    return *this;
 }
 
 template<detail::expression L, detail::expression R>
@@ -109,9 +213,13 @@ constexpr mod_expr<L, R> operator%(const L& lhs, const R& rhs) {
 template<sign Sign, unsigned int BitWidth>
 template<detail::expression T>
 constexpr mp_int<Sign, BitWidth>& mp_int<Sign, BitWidth>::operator%=(T&& e) & noexcept {
-    mp_int<Sign, BitWidth> tmp = *this;
-    mp_int<Sign, BitWidth> etmp(e);
-    return *this = tmp % etmp;
+    const mp_int dividend = *this;
+    mp_int quo;
+    decltype(auto) v = detail::operand_of_width<BitWidth, false>(e);
+    const auto& divisor = detail::same_object(v, *this) ? dividend.value_ : v.value_;
+    detail::naive_mul::div<Sign, BitWidth>(quo.value_, value_, dividend.value_, divisor);
+    normalize();
+    return *this;
 }
 
 }
@@ -0,0 +1,17 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// グローバルなoperator newの呼び出し回数．変換やpmrのアロケータを使う演算がヒープに触れないことを確かめる．
+inline std::atomic<std::size_t> global_new_calls{0};
+
+void* operator new(std::size_t n) {
+    ++global_new_calls;
+    if(void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+// 展開先で対応するnewとfreeの組を誤検出されないように，deleteはインライン展開させない
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
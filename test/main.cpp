@@ -5,5 +5,11 @@
 #include "test_modulus.hpp"
 #include "test_modint.hpp"
 #include "test_fundamental_mul_test.hpp"
+#include "test_accumulator.hpp"
+#include "test_dynamic_mp_int.hpp"
+#include "test_mp_int_vector.hpp"
+#include "test_mp_int_view.hpp"
+#include "test_mp_int_bytes.hpp"
+#include "test_mp_int_file.hpp"
 
 OUCHI_TEST_MAIN;
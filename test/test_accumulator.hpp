@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <random>
+
+#include "chao/mp_int.hpp"
+#include "ouchitest/ouchitest.hpp"
+
+OUCHI_TEST_CASE(test_accumulator_dot_product256) {
+    using namespace chao;
+    typedef mp_int<sign::mp_signed, 256> smpint;
+    const auto seed = std::random_device{}();
+    chao::random_adaptor<std::mt19937_64, 256> rnd(seed);
+    std::mt19937_64 r(seed);
+    accumulator<256> acc, part1, part2;
+    smpint expected = 0, p1 = 0;
+    for(int k = 0; k < 200; ++k) {
+        smpint x = rnd(), y = rnd();
+        if(k % 3 == 0) x = -x;
+        acc += x * y;
+        expected += x * y;
+        (k < 100 ? part1 : part2) += x * y;
+        if(k < 100) p1 += x * y;
+    }
+    OUCHI_REQUIRE_EQUAL(acc.get(), expected);
+    OUCHI_REQUIRE_EQUAL(part1.get(), p1);
+    part1.merge(part2);
+    OUCHI_REQUIRE_EQUAL(part1.get(), expected);
+
+    const std::int64_t s = -(std::int64_t)(r() >> 1);
+    smpint z = rnd();
+    acc -= z;
+    acc += s;
+    acc.add_product(z, 3);
+    expected -= z;
+    expected += s;
+    expected += z * 3;
+    OUCHI_REQUIRE_EQUAL(acc.get(), expected);
+    OUCHI_REQUIRE_EQUAL(smpint(acc), expected);
+}
+
+OUCHI_TEST_CASE(test_accumulator_carries128) {
+    using namespace chao;
+    typedef mp_int<sign::mp_unsigned, 128> umpint;
+    // 最大値の和と積は毎回全ての桁から桁上がりを出す
+    accumulator<128> acc;
+    umpint m = 0, expected = 0;
+    m -= 1;
+    for(int k = 0; k < 50; ++k) {
+        acc += m;
+        acc += m * m;
+        expected += m;
+        expected += m * m;
+    }
+    OUCHI_REQUIRE_EQUAL(acc.get<sign::mp_unsigned>(), expected);
+    accumulator<128> other(m);
+    acc.merge(other);
+    expected += m;
+    OUCHI_REQUIRE_EQUAL(acc.get<sign::mp_unsigned>(), expected);
+}
+
+OUCHI_TEST_CASE(test_accumulator_width255) {
+    using namespace chao;
+    typedef mp_int<sign::mp_unsigned, 255> u255;
+    typedef mp_int<sign::mp_signed, 255> s255;
+    // 2^254 + 2^254は2^255を法として0で，第255ビットへの桁上がりを残してはいけない
+    const u255 half = u255(1) << 254;
+    accumulator<255> acc;
+    acc += half;
+    acc += half;
+    OUCHI_REQUIRE_TRUE(acc.get<sign::mp_unsigned>() == 0);
+    OUCHI_REQUIRE_TRUE(acc.get() == 0);
+    // 0 - 1は全ビットが1
+    const u255 m = u255(0) - 1;
+    acc -= 1;
+    OUCHI_REQUIRE_EQUAL(acc.get<sign::mp_unsigned>(), m);
+    OUCHI_REQUIRE_EQUAL(acc.get(), s255(-1));
+    acc += 1;
+    OUCHI_REQUIRE_TRUE(acc.get<sign::mp_unsigned>() == 0);
+
+    const auto seed = std::random_device{}();
+    chao::random_adaptor<std::mt19937_64, 255> rnd(seed);
+    accumulator<255> sum;
+    u255 expected = 0;
+    for(int k = 0; k < 50; ++k) {
+        const u255 x = rnd(), y = rnd();
+        sum.add_product(x, y);
+        sum -= y;
+        sum += x;
+        expected += x * y;
+        expected -= y;
+        expected += x;
+    }
+    OUCHI_REQUIRE_EQUAL(sum.get<sign::mp_unsigned>(), expected);
+    sum.add_product(m, m);
+    expected += m * m;
+    OUCHI_REQUIRE_EQUAL(sum.get<sign::mp_unsigned>(), expected);
+}
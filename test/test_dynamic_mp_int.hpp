@@ -0,0 +1,152 @@
+#pragma once
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chao/mp_int.hpp"
+#include "ouchitest/ouchitest.hpp"
+#include "global_new_counter.hpp"
+
+OUCHI_TEST_CASE(test_dynamic_mp_int_small) {
+    using namespace chao;
+    dynamic_mp_int a = 12345, b = -678, c;
+    c = a + b;
+    OUCHI_REQUIRE_EQUAL(to_string(c), "11667");
+    c = a * b - 7;
+    OUCHI_REQUIRE_EQUAL(to_string(c), "-8369917");
+    c = b / 7;
+    OUCHI_REQUIRE_EQUAL((std::int64_t)c, -678 / 7);
+    c = b % 7;
+    OUCHI_REQUIRE_EQUAL((std::int64_t)c, -678 % 7);
+    c = (b & 0xff) | (a ^ 3);
+    OUCHI_REQUIRE_EQUAL((std::int64_t)c, (-678 & 0xff) | (12345 ^ 3));
+    OUCHI_REQUIRE_EQUAL((std::int64_t)(b >> 3), -678 >> 3);
+    OUCHI_REQUIRE_TRUE(b < a);
+    OUCHI_REQUIRE_TRUE(a == 12345);
+    OUCHI_REQUIRE_TRUE(!dynamic_mp_int(0));
+    // 小さな値はヒープを使わない
+    OUCHI_REQUIRE_EQUAL(c.capacity(), dynamic_mp_int::small_length);
+    c = std::numeric_limits<std::uint64_t>::max();
+    OUCHI_REQUIRE_TRUE(c > 0);
+    OUCHI_REQUIRE_EQUAL(c.size(), 2u);
+    ++c;
+    OUCHI_REQUIRE_EQUAL(to_string(c), "18446744073709551616");
+    OUCHI_REQUIRE_EQUAL(to_string(-c), "-18446744073709551616");
+    OUCHI_REQUIRE_EQUAL(to_string(~dynamic_mp_int(0)), "-1");
+}
+
+OUCHI_TEST_CASE(test_dynamic_mp_int_vs_fixed1024) {
+    using namespace chao;
+    typedef mp_int<sign::mp_signed, 2048> smpint;
+    const auto seed = std::random_device{}();
+    std::mt19937_64 r(seed);
+    auto gen = [&](unsigned int limbs) {
+        smpint v = 0;
+        for(auto i = 0u; i < limbs; ++i) v.value_.poly[i] = r();
+        return r() & 1 ? smpint(-v) : v;
+    };
+    for(int k = 0; k < 100; ++k) {
+        // 積が2048ビットに収まる大きさ
+        const smpint x = gen(r() % 15 + 1), y = gen(r() % 15 + 1), z = gen(r() % 2 + 1);
+        const dynamic_mp_int X = x, Y = y, Z = z;
+        OUCHI_REQUIRE_EQUAL(smpint(X + Y), smpint(x + y));
+        OUCHI_REQUIRE_EQUAL(smpint(X - Y), smpint(x - y));
+        OUCHI_REQUIRE_EQUAL(smpint(X * Y), smpint(x * y));
+        OUCHI_REQUIRE_EQUAL(smpint(X * Y + Z), smpint(x * y + z));
+        if(y) {
+            OUCHI_REQUIRE_EQUAL(smpint(X / Y), smpint(x / y));
+            OUCHI_REQUIRE_EQUAL(smpint(X % Y), smpint(x % y));
+        }
+        OUCHI_REQUIRE_EQUAL(smpint((X * Y) / Z), smpint((x * y) / z));
+        OUCHI_REQUIRE_EQUAL(smpint((X * Y) % Z), smpint((x * y) % z));
+        OUCHI_REQUIRE_EQUAL(smpint(X & Y), smpint(x & y));
+        OUCHI_REQUIRE_EQUAL(smpint(X | Y), smpint(x | y));
+        OUCHI_REQUIRE_EQUAL(smpint(X ^ Y), smpint(x ^ y));
+        const unsigned int w = r() % 500;
+        OUCHI_REQUIRE_EQUAL(smpint(X << w), smpint(x << w));
+        OUCHI_REQUIRE_EQUAL(smpint(X >> w), smpint(x >> (int)w));
+        OUCHI_REQUIRE_EQUAL(X < Y, x < y);
+        OUCHI_REQUIRE_EQUAL(to_string(X), to_string(x));
+        OUCHI_REQUIRE_EQUAL(dynamic_mp_int(to_string(X)), X);
+        // 自己代入
+        dynamic_mp_int t = X;
+        t *= t;
+        OUCHI_REQUIRE_EQUAL(smpint(t), smpint(x * x));
+        t -= t;
+        OUCHI_REQUIRE_TRUE(!t);
+    }
+}
+
+OUCHI_TEST_CASE(test_dynamic_mp_int_large) {
+    using namespace chao;
+    std::mt19937_64 r(std::random_device{}());
+    // karatsuba法とKnuthの除算が働く大きさ: (a * b + c) / b == a, 余り c
+    for(int k = 0; k < 10; ++k) {
+        dynamic_mp_int a = 1, b = 1, c;
+        for(int i = 0; i < 100 + k * 37; ++i) { a <<= 64; a += r(); }
+        for(int i = 0; i < 60 + k * 11; ++i) { b <<= 64; b += r(); }
+        c = b - 1 - (dynamic_mp_int)r();
+        if(k & 1) a = -a;
+        dynamic_mp_int p = a * b + (k & 1 ? -c : c);
+        OUCHI_REQUIRE_EQUAL(dynamic_mp_int(p / b), a);
+        OUCHI_REQUIRE_EQUAL(dynamic_mp_int(p % b), k & 1 ? -c : c);
+        // (a + b)^2 == a^2 + 2ab + b^2
+        OUCHI_REQUIRE_TRUE((a + b) * (a + b) == a * a + 2 * (a * b) + b * b);
+    }
+    std::ostringstream os;
+    os << (dynamic_mp_int(1) << 200);
+    OUCHI_REQUIRE_EQUAL(os.str(), "1606938044258990275541962092341162602522202993782792835301376");
+}
+
+OUCHI_TEST_CASE(test_dynamic_mp_int_pmr) {
+    using namespace chao;
+    alignas(std::max_align_t) static std::byte buffer[1 << 17];
+    pmr::limb_arena arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    pmr::limb_pool pool(&arena);
+    // 入力と期待値は計測の外で作っておく．10進数字列の分割統治法による変換が働く長さにする
+    struct sample { std::string a, b, sum, quo, bits; };
+    std::vector<sample> samples;
+    std::mt19937_64 mt(std::random_device{}());
+    for(auto i = 0; i < 100; ++i) {
+        dynamic_mp_int ra = (dynamic_mp_int(mt()) << 2100) + mt();
+        dynamic_mp_int rb = (dynamic_mp_int(mt()) << 400) - mt();
+        samples.push_back({to_string(ra), to_string(rb), to_string(ra * rb + ra - rb * 3),
+                           to_string((ra * rb + ra - rb * 3) / rb), to_string((ra % rb) ^ (ra >> 17))});
+    }
+    unsigned int mismatches = 0;
+    const auto pool_loop = [&] {
+        char buf[2000];
+        for(const auto& t : samples) {
+            pmr::dynamic_mp_int a(t.a, 10, &pool), b(t.b, 10, &pool), c(&pool);
+            c = a * b + a;
+            c -= b * 3;
+            mismatches += std::string_view(to_string(c)) != t.sum;
+            c = c / b;
+            mismatches += std::string_view(buf, to_chars(buf, buf + sizeof(buf), c).ptr) != t.quo;
+            c = (a % b) ^ (a >> 17);
+            mismatches += std::string_view(to_string(c)) != t.bits;
+            pmr::dynamic_mp_int d(c, c.get_allocator());
+            mismatches += d.get_allocator().resource() != &pool;
+        }
+    };
+    // 既定のリソースからもグローバルなoperator newからも一切確保させない
+    std::pmr::memory_resource* const prev = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    const auto calls = global_new_calls.load();
+    pool_loop();
+    const auto first_calls = global_new_calls.load() - calls;
+    std::pmr::set_default_resource(prev);
+    OUCHI_REQUIRE_EQUAL(first_calls, 0u);
+    OUCHI_REQUIRE_EQUAL(mismatches, 0u);
+    // 使い終わった桁のバッファはプールに戻るので，アリーナの消費は一定に留まる
+    const auto used = arena.used();
+    std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    pool_loop();
+    const auto second_calls = global_new_calls.load() - calls - first_calls;
+    std::pmr::set_default_resource(prev);
+    OUCHI_REQUIRE_EQUAL(second_calls, 0u);
+    OUCHI_REQUIRE_EQUAL(mismatches, 0u);
+    OUCHI_REQUIRE_EQUAL(arena.used(), used);
+}
@@ -113,3 +113,110 @@ OUCHI_TEST_CASE(test_okmr) {
     OUCHI_REQUIRE_EQUAL((i * g * g).evaluate().get(), modint(1).get());
 #endif
 }
+
+OUCHI_TEST_CASE(test_modint_full_width_modulus) {
+    using namespace chao::literals;
+    // 2^255 - 19．和が符号付き256ビットの最大値を超える
+    constexpr auto p = 0x7fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffed_i256;
+    typedef chao::modint<chao::mod<p>> modint;
+    const chao::uint512_t wp = p;
+    chao::int256_t x = p - 1, y = p - 5;
+    for(int i = 0; i < 16; ++i) {
+        modint a(x), b(y);
+        const chao::uint512_t wx = x, wy = y;
+        const chao::uint512_t sum = (wx + wy) % wp, diff = (wy + wp - wx) % wp, prod = wx * wy % wp;
+        OUCHI_REQUIRE_EQUAL(chao::uint512_t((a + b).evaluate().get()), sum);
+        OUCHI_REQUIRE_EQUAL(chao::uint512_t((b - a).evaluate().get()), diff);
+        OUCHI_REQUIRE_EQUAL(chao::uint512_t((a * b).evaluate().get()), prod);
+        y = x;
+        x = (a * b).evaluate().get();
+    }
+}
+
+OUCHI_TEST_CASE(test_modint_unsigned_full_width_modulus) {
+    using namespace chao::literals;
+    // 2^64 - 59．符号なし64ビットでは和が型の範囲を超える
+    constexpr std::uint64_t p = 0xffffffffffffffc5ull;
+    typedef chao::modint<chao::mod<p>> modint;
+    OUCHI_REQUIRE_EQUAL((modint(p - 1) + modint(p - 2)).evaluate().get(), p - 3);
+    OUCHI_REQUIRE_EQUAL((modint(1) - modint(p - 1)).evaluate().get(), 2u);
+    std::mt19937_64 rnd(std::random_device{}());
+    for(int i = 0; i < 1000; ++i) {
+        const std::uint64_t x = rnd() % p, y = i & 1 ? p - 1 - rnd() % 16 : rnd() % p;
+        const modint a(x), b(y);
+        const auto wx = (unsigned __int128)x, wy = (unsigned __int128)y;
+        OUCHI_REQUIRE_EQUAL((a + b).evaluate().get(), (std::uint64_t)((wx + wy) % p));
+        OUCHI_REQUIRE_EQUAL((a - b).evaluate().get(), (std::uint64_t)((wx + p - wy) % p));
+        OUCHI_REQUIRE_EQUAL((a * b).evaluate().get(), (std::uint64_t)(wx * wy % p));
+    }
+    // 2^128 - 159
+    constexpr auto q = 0xffffffffffffffffffffffffffffff61_u128;
+    typedef chao::modint<chao::mod<q>> modint128;
+    const chao::uint128_t q1 = q - 1, q2 = q - 2, q3 = q - 3;
+    OUCHI_REQUIRE_EQUAL((modint128(q1) + modint128(q2)).evaluate().get(), q3);
+    const chao::uint256_t wq = q;
+    chao::uint128_t x = q - 7, y = q - 11;
+    for(int i = 0; i < 16; ++i) {
+        const modint128 a(x), b(y);
+        const chao::uint256_t wx = x, wy = y;
+        const chao::uint256_t sum = (wx + wy) % wq, diff = (wx + wq - wy) % wq;
+        OUCHI_REQUIRE_EQUAL(chao::uint256_t((a + b).evaluate().get()), sum);
+        OUCHI_REQUIRE_EQUAL(chao::uint256_t((a - b).evaluate().get()), diff);
+        y = x;
+        x = (a * b).evaluate().get();
+    }
+    // 符号なしの型でも遅延簡約の差は[0, 2m)に戻る
+    constexpr std::uint64_t r = (1ull << 61) - 1;
+    typedef chao::modint<chao::mod<r>, chao::lazy_reduction> lazy;
+    static_assert(chao::mod<r>::lazy_reducible);
+    for(int i = 0; i < 1000; ++i) {
+        const std::uint64_t u = rnd() % r, v = rnd() % r;
+        OUCHI_REQUIRE_EQUAL((lazy(u) - lazy(v)).evaluate().get(), (u + r - v) % r);
+        OUCHI_REQUIRE_EQUAL((lazy(u) + lazy(v)).evaluate().get(), (u + v) % r);
+    }
+}
+
+OUCHI_TEST_CASE(test_modint_lazy_reduction) {
+    // 2^61 - 1．符号付き64ビットに3ビットの空きがある
+    constexpr std::int64_t p = (1ll << 61) - 1;
+    typedef chao::modint<chao::mod<p>> strict;
+    typedef chao::modint<chao::mod<p>, chao::lazy_reduction> lazy;
+    static_assert(chao::mod<p>::lazy_reducible);
+    static_assert(!chao::mod<(1ll << 62) - 57>::lazy_reducible);
+
+    std::mt19937_64 rnd(1);
+    strict sa(1), sb(1);
+    lazy la(1), lb(1);
+    for(int i = 0; i < 1000; ++i) {
+        const auto x = (std::int64_t)(rnd() % p), y = (std::int64_t)(rnd() % p);
+        sb = strict(x);
+        lb = lazy(y);
+        sa = sa * sb + strict(y) - sa;
+        la = la * lazy(x) + lb - la;
+        OUCHI_REQUIRE_EQUAL(la.get(), sa.get());
+        OUCHI_REQUIRE_TRUE(la == lazy(sa.get()));
+    }
+    strict c = la * la;
+    OUCHI_REQUIRE_EQUAL(c.get(), (sa * sa).evaluate().get());
+}
+
+OUCHI_TEST_CASE(test_modint_lazy_reduction_dynamic) {
+    using namespace chao::literals;
+    constexpr auto bit_len = 384;
+    constexpr auto modulo = chao::stoi<bit_len>("1140686444542216206202086934988038350474531692111");
+    typedef chao::mp_int<chao::sign::mp_signed, bit_len> mpint;
+    typedef chao::modint<chao::dynamic_modulus<mpint>> strict;
+    typedef chao::modint<chao::dynamic_modulus<mpint>, chao::lazy_reduction> lazy;
+    const auto x = 292295048183585810449704743283848056349669201184_i384;
+    lazy g(x, std::in_place, modulo);
+    strict sg(x, std::in_place, modulo);
+    lazy h = g.inv();
+    OUCHI_REQUIRE_EQUAL((h * g).evaluate().get(), 1);
+    strict ss = sg;
+    lazy s = g;
+    for(int i = 0; i < 100; ++i) {
+        s = s + s - h * g;
+        ss = ss + ss - strict(1, std::in_place, modulo);
+        OUCHI_REQUIRE_EQUAL(s.get(), ss.get());
+    }
+}
@@ -31,15 +31,35 @@ OUCHI_TEST_CASE(modulo_compile_test) {
     using namespace chao::literals;
     {
         chao::mod<7_i128> a;
-        OUCHI_REQUIRE_EQUAL(chao::mod_abs<chao::int128_t>(a.R * a.R_inv, a.value), 1);
-        OUCHI_REQUIRE_EQUAL(chao::mod_abs<chao::int128_t>(a.M_dash * a.value, a.R), chao::expr_to_mp_int(a.R - 1));
-        OUCHI_REQUIRE_TRUE(a.R_2 > 0);
+        OUCHI_REQUIRE_EQUAL(a.M_dash * 7, ~0ull);
+        // R = 2^128, R^2 mod 7 = 2^256 mod 7 = 2
+        OUCHI_REQUIRE_EQUAL(a.R_2, 2);
+        OUCHI_REQUIRE_EQUAL(a.montgomery_reduction(a.montgomery_representation(5_i128)), 5);
     }
     {
         chao::mod<7> a;
-        OUCHI_REQUIRE_EQUAL(chao::mod_abs<chao::int128_t>(a.R * a.R_inv, a.value), 1);
-        OUCHI_REQUIRE_EQUAL(chao::mod_abs<chao::int128_t>(a.M_dash * a.value, a.R), chao::expr_to_mp_int(a.R - 1));
-        OUCHI_REQUIRE_TRUE(a.R_2 > 0);
+        OUCHI_REQUIRE_EQUAL(a.M_dash * 7, ~0ull);
+        // R = 2^64, R^2 mod 7 = 2^128 mod 7 = 4
+        OUCHI_REQUIRE_EQUAL(a.R_2, 4);
+        OUCHI_REQUIRE_EQUAL(a.montgomery_reduction(a.montgomery_representation(-3)), 4);
+    }
+}
+
+OUCHI_TEST_CASE(montgomery_multiply_large_modulus_test) {
+    using namespace chao::literals;
+    // 2^255 - 19
+    constexpr auto p = 0x7fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffed_i256;
+    typedef chao::mod<p> mod_type;
+    mod_type m;
+    chao::uint512_t wp = p;
+    chao::int256_t a = p - 1, b = p - 2;
+    for(int i = 0; i < 16; ++i) {
+        const auto r = m.montgomery_reduction(m.montgomery_multiply(m.montgomery_representation(a), m.montgomery_representation(b)));
+        chao::uint512_t wa = a, wb = b;
+        chao::uint512_t expect = wa * wb % wp;
+        OUCHI_REQUIRE_EQUAL(chao::uint512_t(r), expect);
+        b = a;
+        a = r;
     }
 }
 
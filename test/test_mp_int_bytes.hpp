@@ -0,0 +1,71 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <random>
+
+#include "chao/mp_int.hpp"
+#include "ouchitest/ouchitest.hpp"
+
+OUCHI_TEST_CASE(test_mp_int_bytes) {
+    using namespace chao;
+    using namespace chao::literals;
+    typedef mp_int<sign::mp_signed, 256> int256;
+    typedef mp_int<sign::mp_unsigned, 256> uint256;
+    typedef mp_int<sign::mp_signed, 100> int100;
+
+    // ネットワークバイトオーダー
+    unsigned char be[32];
+    const uint256 key = 0x0102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f20_u256;
+    export_bytes(be, sizeof(be), key);
+    for(int i = 0; i < 32; ++i) OUCHI_REQUIRE_EQUAL((int)be[i], i + 1);
+    uint256 k;
+    import_bytes(k, be, sizeof(be));
+    OUCHI_REQUIRE_EQUAL(k, key);
+    // 下位の語から，語の中はビッグエンディアン
+    unsigned char w[32];
+    export_bytes(w, sizeof(w), key, 4, word_order::least_significant_first, std::endian::big);
+    OUCHI_REQUIRE_EQUAL((int)w[0], 0x1d);
+    OUCHI_REQUIRE_EQUAL((int)w[3], 0x20);
+    OUCHI_REQUIRE_EQUAL((int)w[28], 0x01);
+    import_bytes(k, w, sizeof(w), 4, word_order::least_significant_first, std::endian::big);
+    OUCHI_REQUIRE_EQUAL(k, key);
+
+    // 符号拡張と切り詰め
+    unsigned char s[5];
+    export_bytes(s, sizeof(s), int256(-2));
+    for(int i = 0; i < 4; ++i) OUCHI_REQUIRE_EQUAL((int)s[i], 0xFF);
+    OUCHI_REQUIRE_EQUAL((int)s[4], 0xFE);
+    int256 x;
+    import_bytes(x, s, sizeof(s));
+    OUCHI_REQUIRE_EQUAL(x, -2);
+    import_bytes(k, s, sizeof(s));
+    OUCHI_REQUIRE_EQUAL(k, 0xFFFFFFFFFE_u256);
+    export_bytes(s, sizeof(s), int256(-2), 1, word_order::most_significant_first, std::endian::big, signed_encoding::magnitude);
+    import_bytes(x, s, sizeof(s), 1, word_order::most_significant_first, std::endian::big, signed_encoding::magnitude);
+    OUCHI_REQUIRE_EQUAL(x, 2);
+    unsigned char wide[40];
+    export_bytes(wide, sizeof(wide), int100(-1), 8, word_order::least_significant_first, std::endian::little);
+    for(auto c : wide) OUCHI_REQUIRE_EQUAL((int)c, 0xFF);
+    OUCHI_CHECK_THROW(export_bytes(wide, 39, key, 8), std::invalid_argument&);
+
+    // 全ての並びで往復できる
+    const auto seed = std::random_device{}();
+    chao::random_adaptor<std::mt19937_64, 256> rnd(seed);
+    for(int t = 0; t < 20; ++t) {
+        const int256 v = rnd();
+        for(std::size_t ws : {1, 2, 4, 8, 16, 32}) {
+            for(auto order : {word_order::most_significant_first, word_order::least_significant_first}) {
+                for(auto endian : {std::endian::big, std::endian::little}) {
+                    unsigned char buf[64];
+                    export_bytes(buf, 64, v, ws, order, endian);
+                    int256 y;
+                    import_bytes(y, buf, 64, ws, order, endian);
+                    OUCHI_REQUIRE_EQUAL(y, v);
+                    int100 z;
+                    import_bytes(z, buf, 64, ws, order, endian);
+                    OUCHI_REQUIRE_EQUAL(z, int100(v));
+                }
+            }
+        }
+    }
+}
@@ -2,9 +2,11 @@
 #include "ouchitest/ouchitest.hpp"
 
 #include <string>
+#include <random>
 #include <sstream>
 
 #include "chao/mp_int.hpp"
+#include "global_new_counter.hpp"
 
 OUCHI_TEST_CASE(test_cvt_into_mp_int_from_str) {
     size_t idx;
@@ -54,3 +56,259 @@ OUCHI_TEST_CASE(test_io_mp_int) {
 
     OUCHI_REQUIRE_EQUAL(result.str(), "123456-112345");
 }
+
+OUCHI_TEST_CASE(test_cvt_into_str_dc8192) {
+    using namespace chao;
+    typedef mp_int<sign::mp_signed, 8192> smpint;
+    // 10^2000 - 1は2000個の9
+    smpint x = 1;
+    for(int i = 0; i < 2000; ++i) x *= 10;
+    OUCHI_REQUIRE_EQUAL(to_string(x - 1), std::string(2000, '9'));
+    OUCHI_REQUIRE_EQUAL(to_string(x + 12345), "1" + std::string(1995, '0') + "12345");
+    OUCHI_REQUIRE_EQUAL(to_string(smpint(-x)), "-1" + std::string(2000, '0'));
+
+    const auto seed = std::random_device{}();
+    chao::random_adaptor<std::mt19937_64, 8192> rnd(seed);
+    for(int k = 0; k < 5; ++k) {
+        const smpint v = rnd();
+        smpint w = v >> (k * 1500);
+        const auto s = to_string(w);
+        OUCHI_REQUIRE_EQUAL(s, to_string(dynamic_mp_int(w)));
+        OUCHI_REQUIRE_EQUAL(smpint(stoi<8192>(s)), w);
+    }
+}
+
+OUCHI_TEST_CASE(test_cvt_into_mp_int_from_long_str) {
+    using namespace chao;
+    typedef mp_int<sign::mp_unsigned, 4096> umpint;
+    // 2の冪の基数は桁に直接並べる
+    umpint p = 1;
+    p <<= 4000;
+    OUCHI_REQUIRE_EQUAL(stoul<4096>("1" + std::string(1000, '0'), nullptr, 16), p);
+    OUCHI_REQUIRE_EQUAL(stoul<4096>("1" + std::string(4000, '0'), nullptr, 2), p);
+    OUCHI_REQUIRE_EQUAL(stoul<4096>("0x" + std::string(1024, 'f'), nullptr, 0), umpint(~umpint(0)));
+    OUCHI_REQUIRE_EQUAL(stoul<4096>("7" + std::string(700, '7'), nullptr, 8), umpint((umpint(1) << 2103) - 1));
+    // 分割統治法の境界をまたぐ長さの10進数
+    for(int n : {7, 8, 19, 20, 455, 456, 457, 1000, 1234}) {
+        umpint x = 1;
+        for(int i = 0; i < n; ++i) x *= 10;
+        std::size_t idx = 0;
+        OUCHI_REQUIRE_EQUAL(stoul<4096>("1" + std::string(n, '0') + "x", &idx), x);
+        OUCHI_REQUIRE_EQUAL(idx, (std::size_t)n + 1);
+        OUCHI_REQUIRE_EQUAL(stoul<4096>(std::string(n, '9')), umpint(x - 1));
+    }
+    // 幅を超える値は2^BitWidthを法とする
+    OUCHI_REQUIRE_EQUAL(stoul<64>("18446744073709551617"), expr_to_mp_int(1u));
+    // 幅に収まる桁数よりずっと長い10進数
+    std::mt19937_64 mt(std::random_device{}());
+    for(std::size_t n : {std::size_t(4096), std::size_t(10000), std::size_t(25000)}) {
+        std::string str(n, '1');
+        if(n != 10000) for(auto& ch : str) ch = (char)('0' + mt() % 10);
+        umpint expected = 0;
+        for(char ch : str) expected = expected * 10 + (ch - '0');
+        OUCHI_REQUIRE_EQUAL(stoul<4096>(str), expected);
+        typedef mp_int<sign::mp_unsigned, 1000> u1000;
+        const u1000 narrow = expected;
+        OUCHI_REQUIRE_EQUAL(stoul<1000>(str), narrow);
+    }
+    constexpr auto c = stoul<256>("123456789012345678901234567890");
+    OUCHI_REQUIRE_EQUAL(to_string(c), "123456789012345678901234567890");
+}
+
+OUCHI_TEST_CASE(test_to_chars_from_chars) {
+    using namespace chao;
+    using namespace chao::literals;
+    typedef mp_int<sign::mp_signed, 128> smpint;
+    typedef mp_int<sign::mp_unsigned, 128> umpint;
+    char buf[200];
+    auto str = [&](const auto& v, int base) {
+        const auto r = to_chars(buf, buf + sizeof(buf), v, base);
+        return std::string(buf, r.ptr);
+    };
+    OUCHI_REQUIRE_EQUAL(str(-123456_i128, 10), "-123456");
+    OUCHI_REQUIRE_EQUAL(str(0_i128, 16), "0");
+    OUCHI_REQUIRE_EQUAL(str(0xabcdef0123456789abcdef_u128, 16), "abcdef0123456789abcdef");
+    OUCHI_REQUIRE_EQUAL(str(umpint(~umpint(0)), 2), std::string(128, '1'));
+    OUCHI_REQUIRE_EQUAL(str(umpint(~umpint(0)), 8), "3" + std::string(42, '7'));
+    OUCHI_REQUIRE_EQUAL(str(expr_to_mp_int(-35), 36), "-z");
+    OUCHI_REQUIRE_EQUAL(str(smpint(smpint(1) << 127), 10), "-170141183460469231731687303715884105728");
+    // 収まらなければvalue_too_large
+    const auto r = to_chars(buf, buf + 5, 123456_i128);
+    OUCHI_REQUIRE_TRUE(r.ec == std::errc::value_too_large && r.ptr == buf + 5);
+    OUCHI_REQUIRE_TRUE(to_chars(buf, buf + 6, 123456_i128).ec == std::errc{});
+
+    std::string_view s = "-170141183460469231731687303715884105728 ";
+    smpint x = 1;
+    auto f = from_chars(s.data(), s.data() + s.size(), x);
+    OUCHI_REQUIRE_TRUE(f.ec == std::errc{} && f.ptr == s.data() + s.size() - 1);
+    OUCHI_REQUIRE_EQUAL(x, smpint(smpint(1) << 127));
+    s = "170141183460469231731687303715884105728";
+    f = from_chars(s.data(), s.data() + s.size(), x);
+    OUCHI_REQUIRE_TRUE(f.ec == std::errc::result_out_of_range && f.ptr == s.data() + s.size());
+    umpint u = 7;
+    s = "-1";
+    f = from_chars(s.data(), s.data() + s.size(), u);
+    OUCHI_REQUIRE_TRUE(f.ec == std::errc::invalid_argument && f.ptr == s.data());
+    OUCHI_REQUIRE_EQUAL(u, 7);
+    s = "000000000000000000000000000000000000000000000ffffffffffffffffffffffffffffffffxyz";
+    f = from_chars(s.data(), s.data() + s.size(), u, 16);
+    OUCHI_REQUIRE_TRUE(f.ec == std::errc{} && f.ptr == s.data() + s.size() - 3);
+    OUCHI_REQUIRE_EQUAL(u, umpint(~umpint(0)));
+    s = "1ffffffffffffffffffffffffffffffff";
+    OUCHI_REQUIRE_TRUE(from_chars(s.data(), s.data() + s.size(), u, 16).ec == std::errc::result_out_of_range);
+    s = "340282366920938463463374607431768211456";
+    OUCHI_REQUIRE_TRUE(from_chars(s.data(), s.data() + s.size(), u).ec == std::errc::result_out_of_range);
+    s = "340282366920938463463374607431768211455";
+    OUCHI_REQUIRE_TRUE(from_chars(s.data(), s.data() + s.size(), u).ec == std::errc{});
+    OUCHI_REQUIRE_EQUAL(u, umpint(~umpint(0)));
+
+    // リテラルは接頭辞で基数を決める
+    OUCHI_REQUIRE_EQUAL(0x1f_u128, 31);
+    OUCHI_REQUIRE_EQUAL(0b101_i128, 5);
+    // 先頭の0は8進数の接頭辞にしない
+    OUCHI_REQUIRE_EQUAL(017_u128, 17);
+    OUCHI_REQUIRE_EQUAL(0123_i256, 123);
+    static_assert(detail::parse_literal<sign::mp_unsigned, 128>("0o17") == 15);
+
+    std::stringstream ss("340282366920938463463374607431768211456");
+    OUCHI_CHECK_THROW(ss >> u, std::out_of_range&);
+    // 先頭の0はいくつ続いてもよく，収まらない値は数字の並びを読み切ってから報告する
+    typedef mp_int<sign::mp_signed, 128> smpint;
+    smpint i;
+    ss.clear();
+    ss.str(std::string(200, '0') + "123 -" + std::string(100, '0') + "45 000 -0 "
+           + std::string(500, '9') + " 7 " + "340282366920938463463374607431768211455" + std::string(60, '0') + "x 8");
+    ss >> i;
+    OUCHI_REQUIRE_EQUAL(i, 123);
+    ss >> i;
+    OUCHI_REQUIRE_EQUAL(i, -45);
+    ss >> i;
+    OUCHI_REQUIRE_EQUAL(i, 0);
+    ss >> i;
+    OUCHI_REQUIRE_EQUAL(i, 0);
+    OUCHI_CHECK_THROW(ss >> i, std::out_of_range&);
+    ss.clear();
+    ss >> i;
+    OUCHI_REQUIRE_EQUAL(i, 7);
+    OUCHI_CHECK_THROW(ss >> u, std::out_of_range&);
+    ss.clear();
+    OUCHI_REQUIRE_EQUAL(ss.get(), 'x');
+    ss >> u;
+    OUCHI_REQUIRE_EQUAL(u, 8);
+}
+
+OUCHI_TEST_CASE(test_cvt_into_str_dc_large) {
+    using namespace chao;
+    typedef mp_int<sign::mp_unsigned, 32768> umpint;
+    // 分割統治法の結果を10^19で割り続ける単純な方法と比べ，読み戻す
+    const auto chunked = [](umpint v) {
+        std::string s(detail::max_chars(32768, 10), '\0');
+        s.resize(detail::write_chunked(s.data(), s.data() + s.size(), v.value_.poly.data(), v.length, 10) - s.data());
+        return s;
+    };
+    const auto seed = std::random_device{}();
+    chao::random_adaptor<std::mt19937_64, 32768> rnd(seed);
+    umpint p = 1;
+    for(int i = 0; i < 9000; ++i) p *= 10;
+    const umpint ones = umpint(0) - 1;
+    std::vector<umpint> values = {p, p - 1, p + 1, ones, ones >> 5000, umpint(rnd()) >> 20000};
+    for(int k = 0; k < 3; ++k) {
+        umpint v = rnd();
+        // 10の冪の境目に0や9が長く続く値
+        for(int i = 100 * k; i < 100 * k + 150; ++i) v.value_.poly[i] = 0;
+        values.push_back(v);
+    }
+    for(const auto& v : values) {
+        const auto s = to_string(v);
+        OUCHI_REQUIRE_EQUAL(s, chunked(v));
+        OUCHI_REQUIRE_EQUAL(stoul<32768>(s), v);
+        OUCHI_REQUIRE_EQUAL(to_string(dynamic_mp_int(v)), s);
+        // from_charsと>>は幅ごとに一度だけ作った10の冪の表を使い回す
+        umpint w = 0;
+        OUCHI_REQUIRE_TRUE(from_chars(s.data(), s.data() + s.size(), w).ec == std::errc{});
+        OUCHI_REQUIRE_EQUAL(w, v);
+        std::istringstream is(s);
+        is >> w;
+        OUCHI_REQUIRE_EQUAL(w, v);
+    }
+    OUCHI_REQUIRE_EQUAL(to_string(p - 1), std::string(9000, '9'));
+}
+
+OUCHI_TEST_CASE(test_format_mp_int) {
+    using namespace chao;
+    using namespace chao::literals;
+    // std::formatterと同じ手順で書式指定を読んで書く
+    auto fmt = [](std::string_view spec, const auto& v) {
+        detail::format_spec s;
+        s.parse(spec.data(), spec.data() + spec.size());
+        char buf[200];
+        const auto r = to_chars(buf, buf + sizeof(buf), v, s.base());
+        const bool negative = buf[0] == '-';
+        std::string out;
+        s.write(std::back_inserter(out), std::string_view(buf + negative, r.ptr - buf - negative), negative);
+        return out;
+    };
+    OUCHI_REQUIRE_EQUAL(fmt("", -1234567_i128), "-1234567");
+    OUCHI_REQUIRE_EQUAL(fmt(",", -1234567_i128), "-1,234,567");
+    OUCHI_REQUIRE_EQUAL(fmt("#X", 0xabcdef_u128), "0XABCDEF");
+    OUCHI_REQUIRE_EQUAL(fmt("#_b", 0b1010101_u128), "0b101_0101");
+    OUCHI_REQUIRE_EQUAL(fmt("+012", 42_i128), "+00000000042");
+    OUCHI_REQUIRE_EQUAL(fmt("*^9", 42_i128), "***42****");
+    OUCHI_REQUIRE_EQUAL(fmt("<5", 42_i128), "42   ");
+    OUCHI_REQUIRE_EQUAL(fmt("#o", 0_u128), "0");
+    detail::format_spec bad;
+    std::string_view spec = "q}";
+    OUCHI_REQUIRE_TRUE(bad.parse(spec.data(), spec.data() + spec.size()) == nullptr);
+    // 分割統治法を使う幅でも，表と作業領域をその幅に合わせた後の変換は確保しない
+    typedef mp_int<sign::mp_signed, 8192> wide;
+    wide w = 1;
+    for(int k = 0; k < 2000; ++k) w *= 10;
+    const wide wn = 7 - w;
+    std::array<char, detail::max_chars(8192, 2) + 1> wbuf;
+    detail::format_spec comma;
+    std::string_view spec_comma = ",";
+    comma.parse(spec_comma.data(), spec_comma.data() + spec_comma.size());
+    to_chars(wbuf.data(), wbuf.data() + wbuf.size(), w);
+    const auto calls = global_new_calls.load();
+    const auto wr = to_chars(wbuf.data(), wbuf.data() + wbuf.size(), wn);
+    OUCHI_REQUIRE_EQUAL(global_new_calls.load(), calls);
+    std::string grouped;
+    comma.write(std::back_inserter(grouped), std::string_view(wbuf.data() + 1, wr.ptr - wbuf.data() - 1), true);
+    // 10^2000 - 7は2000桁で，先頭の2桁の後に3桁の組が666個続く
+    std::string expected = "-99";
+    for(int k = 0; k < 665; ++k) expected += ",999";
+    expected += ",993";
+    OUCHI_REQUIRE_EQUAL(grouped, expected);
+#if defined(__cpp_lib_format)
+    OUCHI_REQUIRE_EQUAL(std::format("{:,}", wn), expected);
+    OUCHI_REQUIRE_EQUAL(std::format("{:>#12_x}", 0xdeadbeef_u128), " 0xdead_beef");
+    OUCHI_REQUIRE_EQUAL(std::format("{}", 123_i128 * 2), "246");
+#endif
+}
+
+OUCHI_TEST_CASE(test_mp_int_literals) {
+    using namespace chao;
+    using namespace chao::literals;
+    typedef mp_int<sign::mp_signed, 64> int64;
+    typedef mp_int<sign::mp_signed, 128> int128;
+    typedef mp_int<sign::mp_unsigned, 64> uint64;
+    typedef mp_int<sign::mp_unsigned, 192> uint192;
+    // 幅は値から決まり，符号付きは符号ビットの分を空ける
+    static_assert(std::is_same_v<decltype(1_mp), int64>);
+    static_assert(std::is_same_v<decltype(0x7fff'ffff'ffff'ffff_mp), int64>);
+    static_assert(std::is_same_v<decltype(0x8000'0000'0000'0000_mp), int128>);
+    static_assert(std::is_same_v<decltype(0xffff'ffff'ffff'ffff_ump), uint64>);
+    static_assert(std::is_same_v<decltype(0x1'0000'0000'0000'0000'0000'0000'0000'0000_ump), uint192>);
+    static_assert(std::is_same_v<decltype(1_i512), int512_t>);
+    static_assert(std::is_same_v<decltype(1_u512), uint512_t>);
+    // コンパイル時に読む
+    constexpr auto big = 1'000'000'000'000'000'000'000'000'000'000_mp;
+    static_assert(big == 1'000'000'000'000'000'000'000'000'000'000_i128);
+    static_assert(0b1010'1010_mp == 170);
+    static_assert(0777_ump == 777);
+    static_assert(0xFFFF_u128 == 65535);
+    OUCHI_REQUIRE_EQUAL(to_string(big), "1" + std::string(30, '0'));
+    OUCHI_REQUIRE_EQUAL(to_string(-0x8000'0000'0000'0000_mp), "-9223372036854775808");
+    OUCHI_REQUIRE_EQUAL(to_string(0xffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff'ffff_u512),
+        "115792089237316195423570985008687907853269984665640564039457584007913129639935");
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "chao/mp_int.hpp"
+#include "ouchitest/ouchitest.hpp"
+
+OUCHI_TEST_CASE(test_mp_int_file256) {
+    using namespace chao;
+    typedef mp_int<sign::mp_signed, 256> int256;
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto bin = dir / "chao_test_mp_int_file.bin";
+    const auto txt = dir / "chao_test_mp_int_file.txt";
+
+    const auto seed = std::random_device{}();
+    chao::random_adaptor<std::mt19937_64, 256> rnd(seed);
+    std::vector<int256> values;
+    for(int i = 0; i < 10000; ++i) values.push_back(int256(rnd()) >> (i % 256));
+    {
+        // バッファが何度も溢れるように小さくする
+        mp_int_file_writer<sign::mp_signed, 256> w(bin, 4096);
+        w.write(values);
+        w.push(values[0] * 3);
+    }
+    {
+        mp_int_file_reader<sign::mp_signed, 256> r(bin);
+        OUCHI_REQUIRE_EQUAL(r.size(), values.size() + 1);
+        const auto records = r.records();
+        bool same = true;
+        for(std::size_t i = 0; i < values.size(); ++i) same = same && records[i] == values[i] && r[i] == values[i];
+        OUCHI_REQUIRE_TRUE(same);
+        OUCHI_REQUIRE_EQUAL(records.back(), int256(values[0] * 3));
+        OUCHI_CHECK_THROW((mp_int_file_reader<sign::mp_unsigned, 256>(bin)), std::runtime_error&);
+    }
+    {
+        // レコード数 * 32が2^64で巻き戻って小さくなる値でも切り詰められたファイルとして弾く
+        std::fstream f(bin, std::ios::in | std::ios::out | std::ios::binary);
+        const std::uint64_t count = (std::uint64_t(1) << 59) + 1;
+        f.seekp(offsetof(mp_int_file_header, record_count));
+        f.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    }
+    OUCHI_CHECK_THROW((mp_int_file_reader<sign::mp_signed, 256>(bin)), std::runtime_error&);
+    {
+        std::ofstream t(txt);
+        for(std::size_t i = 0; i < 1000; ++i) t << values[i] << (i % 7 ? " " : "\n");
+    }
+    OUCHI_REQUIRE_EQUAL((convert_text_to_mp_int_file<sign::mp_signed, 256>(txt, bin)), 1000u);
+    {
+        mp_int_file_reader<sign::mp_signed, 256> r(bin);
+        bool same = r.size() == 1000;
+        for(std::size_t i = 0; same && i < r.size(); ++i) same = r.records()[i] == values[i];
+        OUCHI_REQUIRE_TRUE(same);
+    }
+    {
+        std::ofstream t(txt);
+        t << "12 -3";
+    }
+    OUCHI_CHECK_THROW((convert_text_to_mp_int_file<sign::mp_unsigned, 256>(txt, bin)), std::invalid_argument&);
+    std::filesystem::remove(bin);
+    std::filesystem::remove(txt);
+}
+
+OUCHI_TEST_CASE(test_mp_int_text_writer) {
+    using namespace chao;
+    typedef mp_int<sign::mp_signed, 256> int256;
+    const auto path = std::filesystem::temp_directory_path() / "chao_test_mp_int_text.txt";
+    auto read_all = [&] {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    };
+
+    const auto seed = std::random_device{}();
+    chao::random_adaptor<std::mt19937_64, 256> rnd(seed);
+    std::vector<int256> values;
+    std::string expected, expected_hex;
+    for(int i = 0; i < 5000; ++i) {
+        values.push_back(int256(rnd()) >> (i % 256));
+        expected += to_string(values.back()) + ", ";
+        char buf[80];
+        expected_hex += std::string(buf, to_chars(buf, buf + sizeof(buf), values.back(), 16).ptr) + ", ";
+    }
+    // 小さなバッファで何度も書き出す
+    for(unsigned int threads : {1u, 4u}) {
+        {
+            mp_int_text_writer w(path, ", ", 10, 1000);
+            w.write_range(values, threads);
+        }
+        OUCHI_REQUIRE_EQUAL(read_all(), expected);
+    }
+    {
+        mp_int_text_writer w(path, ", ", 16, 1000);
+        w.write_range(values, 3);
+    }
+    OUCHI_REQUIRE_EQUAL(read_all(), expected_hex);
+    // ブロックがスレッドより少ない範囲と空の範囲
+    {
+        mp_int_text_writer w(path, ", ", 10, 1000);
+        w.write_range(std::span(values).first(3), 8);
+        w.write_range(std::span(values).first(0), 8);
+        w.write_range(std::span(values).subspan(3), 2);
+    }
+    OUCHI_REQUIRE_EQUAL(read_all(), expected);
+    {
+        mp_int_text_writer w(path, " ");
+        w.write(values[0] * 2).write(expr_to_mp_int(-7));
+    }
+    OUCHI_REQUIRE_EQUAL(read_all(), to_string(values[0] * 2) + " -7 ");
+    std::filesystem::remove(path);
+}
@@ -89,6 +89,35 @@ OUCHI_TEST_CASE(test_bitop_expr_tmpl128) {
     }
 }
 
+OUCHI_TEST_CASE(test_fused_bitop_expr_tmpl4096) {
+    using namespace chao;
+    typedef mp_int<sign::mp_unsigned, 4096> umpint;
+    const auto seed = std::random_device{}();
+    chao::random_adaptor<std::mt19937_64, 4096> rnd(seed);
+    std::mt19937_64 r(seed);
+    for(int k = 0; k < 20; ++k) {
+        umpint a = rnd(), b = rnd(), c = rnd(), d = rnd(), e, f;
+        mp_int<sign::mp_signed, 128> n = -(std::int64_t)(r() >> 1);
+        e = (a ^ b) & (c | d);
+        f = a;
+        f ^= b;
+        umpint g = c;
+        g |= d;
+        f &= g;
+        OUCHI_REQUIRE_EQUAL(e, f);
+        // sign extension of a narrower leaf
+        e = (a & n) | (b + c);
+        f = b + c;
+        for(auto i = 0u; i < f.length; ++i) {
+            OUCHI_REQUIRE_EQUAL(e.value_.poly[i], f.value_.poly[i] | (a.value_.poly[i] & (i < n.length ? n.value_.poly[i] : ~0ull)));
+        }
+        // destination aliases a leaf
+        f = a;
+        f = (f ^ b) & (f | c);
+        OUCHI_REQUIRE_EQUAL(f, expr_to_mp_int((a ^ b) & (a | c)));
+    }
+}
+
 OUCHI_TEST_CASE(test_shift_tmpl128){
     using namespace chao;
     mp_int<sign::mp_unsigned, 128> i, j, r;
@@ -166,6 +195,42 @@ OUCHI_TEST_CASE(test_shiftl_tmpl512){
     }
 }
 
+OUCHI_TEST_CASE(test_shift_const_tmpl1024){
+    using namespace chao;
+    typedef mp_int<sign::mp_unsigned, 1024> umpint;
+    typedef mp_int<sign::mp_signed, 1024> mpint;
+    const auto seed = std::random_device{}();
+    chao::random_adaptor<std::mt19937_64, 1024> rnd(seed);
+
+    for(int k = 0; k < 100; ++k) {
+        umpint a = rnd(), r, s;
+        mpint b = rnd(), t, u;
+        r = a << std::integral_constant<int, 1>{};
+        s = a << 1;
+        OUCHI_REQUIRE_EQUAL(r, s);
+        r = a << std::integral_constant<int, 130>{};
+        s = a << 130;
+        OUCHI_REQUIRE_EQUAL(r, s);
+        r = a << std::integral_constant<int, 192>{};
+        s = a << 192;
+        OUCHI_REQUIRE_EQUAL(r, s);
+        r = a >> std::integral_constant<int, 67>{};
+        s = a >> 67;
+        OUCHI_REQUIRE_EQUAL(r, s);
+        t = b >> std::integral_constant<int, 67>{};
+        u = b >> 67;
+        OUCHI_REQUIRE_EQUAL(t, u);
+        t = b >> std::integral_constant<int, 1100>{};
+        OUCHI_REQUIRE_EQUAL(t, b < 0 ? -1 : 0);
+        for(int w = 0; w < 1024; w += 61) {
+            s = a << w;
+            r = a;
+            for(int i = 0; i < w; ++i) r = r << std::integral_constant<int, 1>{};
+            OUCHI_REQUIRE_EQUAL(r, s);
+        }
+    }
+}
+
 OUCHI_TEST_CASE(test_add_expr_tmpl) {
     using namespace chao;
     mp_int<sign::mp_signed, 64> i, j;
@@ -345,6 +410,209 @@ OUCHI_TEST_CASE(test_expr_tmpl) {
     OUCHI_REQUIRE_EQUAL(r, mp_int(0));
 }
 
+OUCHI_TEST_CASE(test_fused_sum_expr_tmpl2048) {
+    using namespace chao;
+    typedef mp_int<sign::mp_signed, 2048> smpint;
+    const auto seed = std::random_device{}();
+    chao::random_adaptor<std::mt19937_64, 2048> rnd(seed);
+    std::mt19937_64 r(seed);
+    for(int k = 0; k < 20; ++k) {
+        smpint a = rnd(), b = rnd(), c = rnd(), d = rnd(), e, f;
+        mp_int<sign::mp_signed, 128> n = -(std::int64_t)(r() >> 1);
+        e = a + b - c + d;
+        f = a; f += b; f -= c; f += d;
+        OUCHI_REQUIRE_EQUAL(e, f);
+        // subtraction of a nested sum negates every term in it
+        e = a - (b + c - d) - n;
+        f = a; f -= b; f -= c; f += d; f -= n;
+        OUCHI_REQUIRE_EQUAL(e, f);
+        // non-additive subexpressions and integral terms
+        e = a * b + (c | d) - 7 + (a >> 5);
+        f = a * b; f += c | d; f -= 7; f += a >> 5;
+        OUCHI_REQUIRE_EQUAL(e, f);
+        // destination aliases a term
+        f = a;
+        f = b + f + f - c;
+        OUCHI_REQUIRE_EQUAL(f, smpint(b + a + a - c));
+    }
+    mp_int<sign::mp_unsigned, 256> m = 0, one = 1, z;
+    m -= 1;
+    z = m + m + m + one + one + one;
+    OUCHI_REQUIRE_EQUAL(z, decltype(z)(0));
+}
+
+OUCHI_TEST_CASE(test_overflow_arith128) {
+    using namespace chao;
+    const auto seed = std::random_device{}();
+    std::mt19937_64 r(seed);
+    auto gen = [&](int k) -> unsigned __int128 {
+        unsigned __int128 v = ((unsigned __int128)r() << 64) | r();
+        // small magnitudes so that both outcomes are exercised
+        return k % 2 ? v : (unsigned __int128)((__int128)(std::int64_t)r() << (r() % 64));
+    };
+    auto to_mp = [](auto v, auto& m) {
+        m.value_.poly[0] = (std::uint64_t)v;
+        m.value_.poly[1] = (std::uint64_t)((unsigned __int128)v >> 64);
+    };
+    for(int k = 0; k < 1000; ++k) {
+        const unsigned __int128 A = gen(k), B = gen(k / 2);
+        {
+            mp_int<sign::mp_unsigned, 128> a, b, out, expected;
+            unsigned __int128 R;
+            to_mp(A, a); to_mp(B, b);
+            bool o = __builtin_add_overflow(A, B, &R); to_mp(R, expected);
+            OUCHI_REQUIRE_EQUAL(add_overflow(a, b, out), o);
+            OUCHI_REQUIRE_EQUAL(out, expected);
+            o = __builtin_sub_overflow(A, B, &R); to_mp(R, expected);
+            OUCHI_REQUIRE_EQUAL(sub_overflow(a, b, out), o);
+            OUCHI_REQUIRE_EQUAL(out, expected);
+            o = __builtin_mul_overflow(A, B, &R); to_mp(R, expected);
+            OUCHI_REQUIRE_EQUAL(mul_overflow(a, b, out), o);
+            OUCHI_REQUIRE_EQUAL(out, expected);
+        }
+        {
+            mp_int<sign::mp_signed, 128> a, b, out, expected;
+            __int128 R;
+            to_mp(A, a); to_mp(B, b);
+            bool o = __builtin_add_overflow((__int128)A, (__int128)B, &R); to_mp(R, expected);
+            OUCHI_REQUIRE_EQUAL(add_overflow(a, b, out), o);
+            OUCHI_REQUIRE_EQUAL(out, expected);
+            o = __builtin_sub_overflow((__int128)A, (__int128)B, &R); to_mp(R, expected);
+            OUCHI_REQUIRE_EQUAL(sub_overflow(a, b, out), o);
+            OUCHI_REQUIRE_EQUAL(out, expected);
+            o = __builtin_mul_overflow((__int128)A, (__int128)B, &R); to_mp(R, expected);
+            OUCHI_REQUIRE_EQUAL(mul_overflow(a, b, out), o);
+            OUCHI_REQUIRE_EQUAL(out, expected);
+            // destination aliases an operand
+            out = b;
+            o = __builtin_sub_overflow((__int128)A, (__int128)B, &R); to_mp(R, expected);
+            OUCHI_REQUIRE_EQUAL(sub_overflow(a, out, out), o);
+            OUCHI_REQUIRE_EQUAL(out, expected);
+        }
+    }
+    mp_int<sign::mp_signed, 256> m = 1, out;
+    m <<= 254;
+    OUCHI_REQUIRE_TRUE(!mul_overflow(m, 1, out));
+    OUCHI_REQUIRE_TRUE(mul_overflow(m, 2, out));
+    OUCHI_REQUIRE_TRUE(!mul_overflow(m, -2, out));
+    OUCHI_REQUIRE_TRUE(mul_overflow(m, -4, out));
+    OUCHI_REQUIRE_TRUE(!add_overflow(m, -1, out));
+}
+
+OUCHI_TEST_CASE(test_overflow_exact_operands) {
+    using namespace chao;
+    // 組み込み関数と同じく，被演算子は変換せずに正確な値で計算する
+    const auto seed = std::random_device{}();
+    std::mt19937_64 r(seed);
+    typedef mp_int<sign::mp_signed, 64> int64;
+    typedef mp_int<sign::mp_unsigned, 64> uint64;
+    typedef mp_int<sign::mp_signed, 128> int128;
+    typedef mp_int<sign::mp_unsigned, 128> uint128;
+    const auto to_mp = [](auto v, auto& m) {
+        m.value_.poly[0] = (std::uint64_t)v;
+        if constexpr (sizeof(v) > 8) m.value_.poly[1] = (std::uint64_t)((unsigned __int128)v >> 64);
+    };
+    for(int k = 0; k < 1000; ++k) {
+        const std::int64_t A = (std::int64_t)r() >> (r() % 64);
+        const std::uint64_t B = r() >> (r() % 64);
+        const int64 a = A;
+        const uint64 b = B;
+        {
+            std::int64_t R;
+            int64 out, expected;
+            bool o = __builtin_add_overflow(A, B, &R); to_mp(R, expected);
+            OUCHI_REQUIRE_EQUAL(add_overflow(a, b, out), o);
+            OUCHI_REQUIRE_EQUAL(out, expected);
+            o = __builtin_sub_overflow(A, B, &R); to_mp(R, expected);
+            OUCHI_REQUIRE_EQUAL(sub_overflow(a, b, out), o);
+            OUCHI_REQUIRE_EQUAL(out, expected);
+            o = __builtin_mul_overflow(A, B, &R); to_mp(R, expected);
+            OUCHI_REQUIRE_EQUAL(mul_overflow(a, b, out), o);
+            OUCHI_REQUIRE_EQUAL(out, expected);
+        }
+        {
+            std::uint64_t R;
+            uint64 out, expected;
+            bool o = __builtin_add_overflow(A, B, &R); to_mp(R, expected);
+            OUCHI_REQUIRE_EQUAL(add_overflow(a, b, out), o);
+            OUCHI_REQUIRE_EQUAL(out, expected);
+            o = __builtin_sub_overflow(B, A, &R); to_mp(R, expected);
+            OUCHI_REQUIRE_EQUAL(sub_overflow(b, a, out), o);
+            OUCHI_REQUIRE_EQUAL(out, expected);
+            o = __builtin_mul_overflow(A, B, &R); to_mp(R, expected);
+            OUCHI_REQUIRE_EQUAL(mul_overflow(a, b, out), o);
+            OUCHI_REQUIRE_EQUAL(out, expected);
+        }
+        {
+            __int128 R;
+            int128 out, expected;
+            bool o = __builtin_mul_overflow(A, B, &R); to_mp(R, expected);
+            OUCHI_REQUIRE_EQUAL(mul_overflow(a, b, out), o);
+            OUCHI_REQUIRE_EQUAL(out, expected);
+            o = __builtin_sub_overflow(A, B, &R); to_mp(R, expected);
+            OUCHI_REQUIRE_EQUAL(sub_overflow(a, b, out), o);
+            OUCHI_REQUIRE_EQUAL(out, expected);
+        }
+    }
+    uint128 u;
+    OUCHI_REQUIRE_TRUE(!add_overflow(mp_int<sign::mp_signed, 256>(-1), 1, u));
+    OUCHI_REQUIRE_EQUAL(u, 0);
+    OUCHI_REQUIRE_TRUE(add_overflow(uint128(0) - 1, 1, u));
+    OUCHI_REQUIRE_EQUAL(u, 0);
+    int128 s;
+    OUCHI_REQUIRE_TRUE(!sub_overflow(uint128(0), 1u, s));
+    OUCHI_REQUIRE_EQUAL(s, -1);
+    OUCHI_REQUIRE_TRUE(mul_overflow(-1, uint128(0) - 1, s));
+    const uint128 half = uint128(1) << 127;
+    const int128 min = half;
+    OUCHI_REQUIRE_TRUE(!mul_overflow(-1, half, s));
+    OUCHI_REQUIRE_EQUAL(s, min);
+}
+
+OUCHI_TEST_CASE(test_compound_assign1024) {
+    using namespace chao;
+    typedef mp_int<sign::mp_signed, 1024> smpint;
+    const auto seed = std::random_device{}();
+    chao::random_adaptor<std::mt19937_64, 1024> rnd(seed);
+    std::mt19937_64 r(seed);
+    for(int k = 0; k < 20; ++k) {
+        smpint a = rnd(), b = rnd(), x;
+        smpint small = -(std::int64_t)(r() >> 1);
+        mp_int<sign::mp_signed, 128> n = -(std::int64_t)(r() >> 1);
+        mp_int<sign::mp_unsigned, 2048> w;
+        w.value_.cpy<sign::mp_signed>(b.value_);
+        w.value_.poly[20] = r();
+        const std::int64_t s = -(std::int64_t)(r() >> 1);
+
+        x = a; x += b; OUCHI_REQUIRE_EQUAL(x, smpint(a + b));
+        x = a; x -= b; OUCHI_REQUIRE_EQUAL(x, smpint(a - b));
+        x = a; x += n; OUCHI_REQUIRE_EQUAL(x, smpint(a + n));
+        x = a; x -= n; OUCHI_REQUIRE_EQUAL(x, smpint(a - n));
+        x = a; x += w; OUCHI_REQUIRE_EQUAL(x, smpint(a + b));
+        x = a; x += s; OUCHI_REQUIRE_EQUAL(x, smpint(a + s));
+        x = a; x -= s; OUCHI_REQUIRE_EQUAL(x, smpint(a - s));
+        x = a; x *= b; OUCHI_REQUIRE_EQUAL(x, smpint(a * b));
+        x = a; x *= n; OUCHI_REQUIRE_EQUAL(x, smpint(a * smpint(n)));
+        x = a; x *= s; OUCHI_REQUIRE_EQUAL(x, smpint(a * smpint(s)));
+        x = a; x /= small; OUCHI_REQUIRE_EQUAL(x, smpint(a / small));
+        x = a; x %= small; OUCHI_REQUIRE_EQUAL(x, smpint(a % small));
+        x = a; x /= n; OUCHI_REQUIRE_EQUAL(x, smpint(a / smpint(n)));
+        x = a; x |= n; OUCHI_REQUIRE_EQUAL(x, smpint(a | n));
+        x = a; x &= b; OUCHI_REQUIRE_EQUAL(x, smpint(a & b));
+        x = a; x ^= b; OUCHI_REQUIRE_EQUAL(x, smpint(a ^ b));
+        x = a; x <<= 77; OUCHI_REQUIRE_EQUAL(x, smpint(a << 77));
+        x = a; x >>= 77; OUCHI_REQUIRE_EQUAL(x, smpint(a >> 77));
+        // operand aliases the destination
+        x = a; x += x; OUCHI_REQUIRE_EQUAL(x, smpint(a + a));
+        x = a; x -= x; OUCHI_REQUIRE_EQUAL(x, smpint(0));
+        x = a; x *= x; OUCHI_REQUIRE_EQUAL(x, smpint(a * a));
+        x = a; x /= x; OUCHI_REQUIRE_EQUAL(x, smpint(1));
+        x = a; x %= x; OUCHI_REQUIRE_EQUAL(x, smpint(0));
+        x = a; x ^= x; OUCHI_REQUIRE_EQUAL(x, smpint(0));
+        x = a; x += x * b; OUCHI_REQUIRE_EQUAL(x, smpint(a + a * b));
+    }
+}
+
 #if 0
 OUCHI_TEST_CASE(mp_int_tmpexpr_add_benchmark) {
     using namespace chao;
@@ -400,4 +668,186 @@ OUCHI_TEST_CASE(mp_int_tmpexpr_add_benchmark128) {
     OUCHI_REQUIRE_EQUAL(res.value_.poly[0], (std::uint64_t)RES);
     OUCHI_REQUIRE_EQUAL(res.value_.poly[1], (std::uint64_t)(RES >> 64));
 }
-#endif
\ No newline at end of file
+#endif
+OUCHI_TEST_CASE(test_odd_width_arith) {
+    using namespace chao;
+    const auto seed = std::random_device{}();
+    std::mt19937_64 r(seed);
+    // 64の倍数でない幅の演算結果は，広い幅で計算してから切り詰めたものに一致する
+    const auto check = [&]<sign S, unsigned int Bits>() {
+        typedef mp_int<S, Bits> narrow;
+        typedef mp_int<S, 1088> wide;
+        const auto canonical = [](const narrow& x) {
+            narrow y = x;
+            y.normalize();
+            return y.value_.poly == x.value_.poly;
+        };
+        chao::random_adaptor<std::mt19937_64, Bits> rnd(r());
+        for(int k = 0; k < 20; ++k) {
+            const narrow a = rnd(), b = rnd();
+            const wide wa = a, wb = b;
+            narrow c;
+            c = a + b; OUCHI_REQUIRE_TRUE(canonical(c)); OUCHI_REQUIRE_EQUAL(c, narrow(wide(wa + wb)));
+            c = a - b; OUCHI_REQUIRE_TRUE(canonical(c)); OUCHI_REQUIRE_EQUAL(c, narrow(wide(wa - wb)));
+            c = a * b; OUCHI_REQUIRE_TRUE(canonical(c)); OUCHI_REQUIRE_EQUAL(c, narrow(wide(wa * wb)));
+            c = a / b; OUCHI_REQUIRE_TRUE(canonical(c)); OUCHI_REQUIRE_EQUAL(c, narrow(wide(wa / wb)));
+            c = a % b; OUCHI_REQUIRE_TRUE(canonical(c)); OUCHI_REQUIRE_EQUAL(c, narrow(wide(wa % wb)));
+            c = a ^ b; OUCHI_REQUIRE_TRUE(canonical(c)); OUCHI_REQUIRE_EQUAL(c, narrow(wide(wa ^ wb)));
+            c = ~a; OUCHI_REQUIRE_TRUE(canonical(c)); OUCHI_REQUIRE_EQUAL(c, narrow(~wa));
+            c = a << 7; OUCHI_REQUIRE_TRUE(canonical(c)); OUCHI_REQUIRE_EQUAL(c, narrow(wide(wa << 7)));
+            c = a >> 7; OUCHI_REQUIRE_TRUE(canonical(c)); OUCHI_REQUIRE_EQUAL(c, narrow(wide(wa >> 7)));
+            c = a; c += b; c *= a; OUCHI_REQUIRE_TRUE(canonical(c)); OUCHI_REQUIRE_EQUAL(c, narrow(wide((wa + wb) * wa)));
+            c = a; c -= b; c <<= 3; OUCHI_REQUIRE_TRUE(canonical(c)); OUCHI_REQUIRE_EQUAL(c, narrow(wide((wa - wb) << 3)));
+            OUCHI_REQUIRE_TRUE((a < b) == (wa < wb));
+        }
+    };
+    check.template operator()<sign::mp_unsigned, 255>();
+    check.template operator()<sign::mp_signed, 255>();
+    check.template operator()<sign::mp_unsigned, 381>();
+    check.template operator()<sign::mp_signed, 381>();
+    check.template operator()<sign::mp_unsigned, 521>();
+    check.template operator()<sign::mp_signed, 521>();
+
+    const mp_int<sign::mp_unsigned, 381> umax = mp_int<sign::mp_unsigned, 381>(0) - 1;
+    OUCHI_REQUIRE_EQUAL(to_string(umax), "4925250774549309901534880012517951725634967408808180833493536675530715221437151326426783281860614455100828498788351");
+    typedef mp_int<sign::mp_unsigned, 381> uint381;
+    typedef mp_int<sign::mp_signed, 255> int255;
+    OUCHI_REQUIRE_TRUE(uint381(umax + 1) == 0);
+    const mp_int<sign::mp_signed, 255> smin = mp_int<sign::mp_signed, 255>(1) << 254;
+    OUCHI_REQUIRE_TRUE(smin < 0);
+    OUCHI_REQUIRE_EQUAL(to_string(smin), "-28948022309329048855892746252171976963317496166410141009864396001978282409984");
+    OUCHI_REQUIRE_TRUE(int255(smin - 1) > 0);
+}
+
+OUCHI_TEST_CASE(test_native_int128_against_wide) {
+    using namespace chao;
+    const auto seed = std::random_device{}();
+    std::mt19937_64 r(seed);
+    // 128ビットの演算はネイティブの__int128を使うので，256ビットで計算して切り詰めたものと比べる
+    const auto check = [&]<sign S>() {
+        typedef mp_int<S, 128> narrow;
+        typedef mp_int<S, 256> wide;
+        const narrow min = narrow(1) << 127;
+        const narrow edges[] = {0, 1, 2, 3, -1, -2, -3, min, min + 1, narrow(min - 1), narrow(1) << 64, narrow(0) - (narrow(1) << 64)};
+        const auto pick = [&](int k) -> narrow {
+            if(k < (int)std::size(edges)) return edges[k];
+            narrow x;
+            x.value_.poly[0] = r();
+            x.value_.poly[1] = k & 1 ? r() : r() >> (r() % 64);
+            if(k & 2) x = narrow(0) - x;
+            return x;
+        };
+        for(int i = 0; i < 64; ++i) {
+            for(int j = 0; j < 64; ++j) {
+                const narrow a = pick(i), b = pick(j);
+                const wide wa = a, wb = b;
+                narrow c;
+                c = a + b; OUCHI_REQUIRE_EQUAL(c, narrow(wide(wa + wb)));
+                c = a - b; OUCHI_REQUIRE_EQUAL(c, narrow(wide(wa - wb)));
+                c = a * b; OUCHI_REQUIRE_EQUAL(c, narrow(wide(wa * wb)));
+                c = a << (j % 130); OUCHI_REQUIRE_EQUAL(c, narrow(wide(wa << (j % 130))));
+                c = a >> (j % 130); OUCHI_REQUIRE_EQUAL(c, narrow(wide(wa >> (j % 130))));
+                OUCHI_REQUIRE_TRUE((a < b) == (wa < wb));
+                OUCHI_REQUIRE_TRUE((a == b) == (wa == wb));
+                // 0除算と最小値 / -1は結果が定まらないので除く
+                if(b == 0 || (S == sign::mp_signed && a == min && b == -1)) continue;
+                c = a / b; OUCHI_REQUIRE_EQUAL(c, narrow(wide(wa / wb)));
+                c = a % b; OUCHI_REQUIRE_EQUAL(c, narrow(wide(wa % wb)));
+            }
+        }
+    };
+    check.template operator()<sign::mp_signed>();
+    check.template operator()<sign::mp_unsigned>();
+}
+
+OUCHI_TEST_CASE(test_overflow_odd_width) {
+    using namespace chao;
+    typedef mp_int<sign::mp_unsigned, 255> uint255;
+    typedef mp_int<sign::mp_signed, 255> int255;
+    typedef mp_int<sign::mp_unsigned, 512> uint512;
+    const auto canonical = [](const auto& x) {
+        auto y = x;
+        y.normalize();
+        return y.value_.poly == x.value_.poly;
+    };
+    const uint255 umax = uint255(0) - 1, top = uint255(1) << 254;
+    uint255 u;
+    OUCHI_REQUIRE_TRUE(add_overflow(umax, 1, u));
+    OUCHI_REQUIRE_TRUE(canonical(u));
+    OUCHI_REQUIRE_EQUAL(u, 0);
+    OUCHI_REQUIRE_TRUE(!add_overflow(top, top - 1, u));
+    OUCHI_REQUIRE_EQUAL(u, umax);
+    OUCHI_REQUIRE_TRUE(mul_overflow(top, 2, u));
+    OUCHI_REQUIRE_TRUE(canonical(u));
+    OUCHI_REQUIRE_EQUAL(u, 0);
+    OUCHI_REQUIRE_TRUE(sub_overflow(0, 1, u));
+    OUCHI_REQUIRE_EQUAL(u, umax);
+
+    const int255 half = int255(1) << 253, smin = int255(1) << 254;
+    int255 s;
+    OUCHI_REQUIRE_TRUE(mul_overflow(half, 2, s));
+    OUCHI_REQUIRE_TRUE(canonical(s));
+    OUCHI_REQUIRE_EQUAL(s, smin);
+    OUCHI_REQUIRE_TRUE(!mul_overflow(half, -2, s));
+    OUCHI_REQUIRE_EQUAL(s, smin);
+    OUCHI_REQUIRE_TRUE(sub_overflow(smin, 1, s));
+    OUCHI_REQUIRE_TRUE(canonical(s));
+    OUCHI_REQUIRE_TRUE(s > 0);
+    OUCHI_REQUIRE_TRUE(add_overflow(int255(smin - 1), 1, s));
+    OUCHI_REQUIRE_EQUAL(s, smin);
+
+    // 広い幅で計算した正確な値と比べる
+    std::mt19937_64 r(std::random_device{}());
+    chao::random_adaptor<std::mt19937_64, 255> rnd(r());
+    for(int k = 0; k < 200; ++k) {
+        const uint255 a = uint255(rnd()) >> (int)(r() % 255), b = uint255(rnd()) >> (int)(r() % 255);
+        const uint512 wa = a, wb = b, lim = uint512(1) << 255;
+        const uint512 sum = wa + wb, prod = wa * wb;
+        OUCHI_REQUIRE_EQUAL(add_overflow(a, b, u), sum >= lim);
+        OUCHI_REQUIRE_EQUAL(u, uint255(sum));
+        OUCHI_REQUIRE_EQUAL(mul_overflow(a, b, u), prod >= lim);
+        OUCHI_REQUIRE_EQUAL(u, uint255(prod));
+        OUCHI_REQUIRE_EQUAL(sub_overflow(a, b, u), a < b);
+    }
+}
+
+OUCHI_TEST_CASE(test_div_multi_limb_divisor) {
+    using namespace chao;
+    typedef mp_int<sign::mp_unsigned, 4096> uint4096;
+    typedef mp_int<sign::mp_signed, 1024> int1024;
+    std::mt19937_64 r(std::random_device{}());
+    // 除数が複数桁のときは実際の桁数でKnuth Dを使う
+    const auto make = [&](unsigned int limbs, auto x) {
+        for(auto i = 0u; i < x.length; ++i) x.value_.poly[i] = i < limbs ? r() : 0;
+        x.normalize();
+        return x;
+    };
+    for(int k = 0; k < 200; ++k) {
+        const uint4096 a = make(2 + r() % 64, uint4096{}), b = make(2 + r() % 8, uint4096{});
+        const uint4096 q = a / b, m = a % b;
+        const uint4096 back = q * b + m;
+        OUCHI_REQUIRE_EQUAL(back, a);
+        OUCHI_REQUIRE_TRUE(m < b);
+    }
+    for(int k = 0; k < 200; ++k) {
+        int1024 a = make(1 + r() % 16, int1024{}), b = make(2 + r() % 4, int1024{});
+        if(k & 1) a = -a;
+        if(k & 2) b = -b;
+        const int1024 q = a / b, m = a % b;
+        const int1024 back = q * b + m;
+        OUCHI_REQUIRE_EQUAL(back, a);
+        OUCHI_REQUIRE_TRUE(abs(m) < abs(b));
+        OUCHI_REQUIRE_TRUE(m == 0 || (m < 0) == (a < 0));
+    }
+    constexpr auto c = [] {
+        mp_int<sign::mp_unsigned, 256> a = 1, b = 3;
+        a <<= 200;
+        b <<= 70;
+        const mp_int<sign::mp_unsigned, 256> q = a / b;
+        return q;
+    }();
+    mp_int<sign::mp_unsigned, 256> expected = 1;
+    expected <<= 130;
+    expected /= 3;
+    OUCHI_REQUIRE_EQUAL(c, expected);
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <random>
+#include <vector>
+
+#include "chao/mp_int.hpp"
+#include "ouchitest/ouchitest.hpp"
+
+OUCHI_TEST_CASE(test_mp_int_vector256) {
+    using namespace chao;
+    const auto seed = std::random_device{}();
+    chao::random_adaptor<std::mt19937_64, 256> rnd(seed);
+    std::vector<uint256_t> a(100), b(100);
+    for(auto& x : a) x = rnd();
+    for(auto& x : b) x = rnd();
+    mp_int_vector<sign::mp_unsigned, 256> va(a), vb(b);
+    OUCHI_REQUIRE_EQUAL(va.size(), 100u);
+    // 桁ごとに連続して並ぶ
+    OUCHI_REQUIRE_EQUAL(va.limb_data(1)[7], a[7].value_.poly[1]);
+    OUCHI_REQUIRE_EQUAL(va.limb_data(3)[8], a[8].value_.poly[3]);
+    OUCHI_REQUIRE_TRUE(va.to_aos() == a);
+
+    auto vc = va;
+    vc += vb;
+    for(auto j = 0u; j < a.size(); ++j) OUCHI_REQUIRE_EQUAL(vc[j].get(), uint256_t(a[j] + b[j]));
+    vc -= va;
+    OUCHI_REQUIRE_TRUE(vc.to_aos() == b);
+    vc = va;
+    vc ^= vb;
+    for(auto j = 0u; j < a.size(); ++j) OUCHI_REQUIRE_EQUAL(vc[j].get(), uint256_t(a[j] ^ b[j]));
+
+    vc.transform([](auto& r, const auto& x, const auto& y) { r = x * y + 1; }, va, vb);
+    for(auto j = 0u; j < a.size(); ++j) OUCHI_REQUIRE_EQUAL(vc[j].get(), uint256_t(a[j] * b[j] + 1));
+
+    // プロキシ参照への代入
+    vc[3] = a[4] - b[5];
+    OUCHI_REQUIRE_EQUAL(vc[3].get(), uint256_t(a[4] - b[5]));
+    vc[4] = vc[3];
+    uint256_t x = vc[4];
+    OUCHI_REQUIRE_EQUAL(x, uint256_t(a[4] - b[5]));
+    unsigned int n = 0;
+    for(uint256_t y : va) OUCHI_REQUIRE_EQUAL(y, a[n++]);
+    OUCHI_REQUIRE_EQUAL(n, 100u);
+
+    // プロキシ参照は式の被演算子になる
+    vc[5] = va[1] * vb[2] + a[3];
+    OUCHI_REQUIRE_EQUAL(vc[5].get(), uint256_t(a[1] * b[2] + a[3]));
+    vc[5] += vb[6];
+    OUCHI_REQUIRE_EQUAL(vc[5].get(), uint256_t(a[1] * b[2] + a[3] + b[6]));
+    const auto& cva = va;
+    OUCHI_REQUIRE_TRUE(a[7] == cva[7]);
+    OUCHI_REQUIRE_EQUAL(uint256_t(cva[7] >> 3), uint256_t(a[7] >> 3));
+
+    // シフトと整数倍は桁ごとに全要素をまとめて処理する
+    for(unsigned int s : {0u, 1u, 63u, 64u, 100u, 192u, 255u, 256u, 300u}) {
+        vc = va;
+        vc <<= s;
+        for(auto j = 0u; j < a.size(); ++j) OUCHI_REQUIRE_EQUAL(vc[j].get(), uint256_t(a[j] << s));
+        vc = va;
+        vc >>= s;
+        for(auto j = 0u; j < a.size(); ++j) OUCHI_REQUIRE_EQUAL(vc[j].get(), uint256_t(a[j] >> s));
+    }
+    vc = va;
+    vc *= 0xfedcba9876543210ull;
+    for(auto j = 0u; j < a.size(); ++j) OUCHI_REQUIRE_EQUAL(vc[j].get(), uint256_t(a[j] * 0xfedcba9876543210ull));
+
+    // 64の倍数でない幅では要素ごとに余りのビットを揃える
+    typedef mp_int<sign::mp_signed, 255> int255;
+    mp_int_vector<sign::mp_signed, 255> s{int255(1) << 253, int255(-1)};
+    auto t = s;
+    s += t;
+    OUCHI_REQUIRE_TRUE(s[0].get() < 0);
+    OUCHI_REQUIRE_EQUAL(s[0].get(), int255(int255(1) << 254));
+    OUCHI_REQUIRE_EQUAL(s[1].get(), int255(-2));
+    s >>= 200;
+    OUCHI_REQUIRE_EQUAL(s[0].get(), int255(int255(-1) << 54));
+    OUCHI_REQUIRE_EQUAL(s[1].get(), int255(-1));
+    s <<= 10;
+    s *= -3;
+    OUCHI_REQUIRE_EQUAL(s[0].get(), int255(int255(3) << 64));
+    OUCHI_REQUIRE_EQUAL(s[1].get(), int255(3 << 10));
+}
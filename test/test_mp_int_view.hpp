@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <random>
+
+#include "chao/mp_int.hpp"
+#include "ouchitest/ouchitest.hpp"
+
+OUCHI_TEST_CASE(test_mp_int_view256) {
+    using namespace chao;
+    typedef mp_int<sign::mp_signed, 256> int256;
+    const auto seed = std::random_device{}();
+    std::mt19937_64 r(seed);
+    // 外部のバッファ．桁はリトルエンディアンで並ぶ
+    std::uint64_t buf[3][4];
+    for(auto& l : buf) for(auto& x : l) x = r();
+    buf[1][3] >>= 1;
+    mp_int_view<sign::mp_signed, 256> a(buf[0]), b(buf[1]), c(buf[2]);
+    const int256 x = a, y = b;
+    OUCHI_REQUIRE_EQUAL(x.value_.poly[2], buf[0][2]);
+    OUCHI_REQUIRE_TRUE(a == x);
+
+    c = a + b;
+    OUCHI_REQUIRE_EQUAL(int256(c), int256(x + y));
+    c = a - b + x;
+    OUCHI_REQUIRE_EQUAL(int256(c), int256(x - y + x));
+    c = a ^ (b | x);
+    OUCHI_REQUIRE_EQUAL(int256(c), int256(x ^ (y | x)));
+    c = a * b;
+    OUCHI_REQUIRE_EQUAL(int256(c), int256(x * y));
+    // 代入先が被演算子と重なっていてもよい
+    c = c * a;
+    OUCHI_REQUIRE_EQUAL(int256(c), int256(int256(x * y) * x));
+    int256 w = x;
+    w = w * y;
+    OUCHI_REQUIRE_EQUAL(w, int256(x * y));
+    c = a;
+    c /= b;
+    OUCHI_REQUIRE_EQUAL(int256(c), int256(x / y));
+    c = a;
+    c %= b;
+    OUCHI_REQUIRE_EQUAL(int256(c), int256(x % y));
+    c = a;
+    c += b;
+    c <<= 5;
+    OUCHI_REQUIRE_EQUAL(int256(c), int256((x + y) << 5));
+    c = -7;
+    OUCHI_REQUIRE_EQUAL(buf[2][3], ~0ull);
+    OUCHI_REQUIRE_TRUE(c < 0);
+
+    // 読み取り専用のビューとmp_intへのビュー
+    int256 z = 0;
+    mp_int_view<sign::mp_signed, 256> vz(z);
+    const const_mp_int_view<sign::mp_signed, 256> ca(static_cast<const std::uint64_t*>(buf[0]));
+    vz = ca * 3 - b;
+    OUCHI_REQUIRE_EQUAL(z, int256(x * 3 - y));
+    z = ca;
+    OUCHI_REQUIRE_EQUAL(z, x);
+    OUCHI_REQUIRE_EQUAL(to_string(ca), to_string(x));
+
+    // 桁はポインタで参照するだけなので，定数式の中でも使える
+    constexpr int256 cx = [] {
+        std::uint64_t limbs[4] = {5, 0, 0, 0};
+        mp_int_view<sign::mp_signed, 256> v(limbs);
+        v = v * v - 30;
+        v <<= 130;
+        const const_mp_int_view<sign::mp_signed, 256> cv(v);
+        return int256(cv + 1);
+    }();
+    OUCHI_REQUIRE_EQUAL(cx, int256((int256(-5) << 130) + 1));
+}
+
+OUCHI_TEST_CASE(test_mp_int_view255) {
+    using namespace chao;
+    typedef mp_int<sign::mp_signed, 255> int255;
+    const auto seed = std::random_device{}();
+    std::mt19937_64 r(seed);
+    std::uint64_t buf[3][4];
+    for(auto& l : buf) for(auto& x : l) x = r();
+    mp_int_view<sign::mp_signed, 255> a(buf[0]), b(buf[1]), c(buf[2]);
+    // 余りのビットを揃えるのは参照先の桁の上で行う
+    a.normalize();
+    b.normalize();
+    OUCHI_REQUIRE_EQUAL(buf[0][3] >> 62, (buf[0][3] >> 62 & 1) ? 3ull : 0ull);
+    const int255 x = a, y = b;
+
+    c = a * b;
+    OUCHI_REQUIRE_EQUAL(int255(c), int255(x * y));
+    c = a / (b >> 100);
+    OUCHI_REQUIRE_EQUAL(int255(c), int255(x / int255(y >> 100)));
+    c = a % (b >> 100);
+    OUCHI_REQUIRE_EQUAL(int255(c), int255(x % int255(y >> 100)));
+    c = a;
+    c *= c;
+    OUCHI_REQUIRE_EQUAL(int255(c), int255(x * x));
+    c = b;
+    c >>= 70;
+    OUCHI_REQUIRE_EQUAL(int255(c), int255(y >> 70));
+    OUCHI_REQUIRE_EQUAL(a < b, x < y);
+    OUCHI_REQUIRE_EQUAL(a <=> y, x <=> y);
+    OUCHI_REQUIRE_TRUE(c == int255(y >> 70));
+
+    // 幅の狭い符号付きの被演算子は符号拡張してから割る
+    const mp_int<sign::mp_signed, 128> n = -10;
+    c = n / int255(3);
+    OUCHI_REQUIRE_EQUAL(int255(c), int255(-3));
+    c = n % int255(3);
+    OUCHI_REQUIRE_EQUAL(int255(c), int255(-1));
+}
@@ -701,3 +701,122 @@ OUCHI_TEST_CASE(unsigned_mp_int_div_test) {
         OUCHI_REQUIRE_EQUAL(rm.poly[0], (std::uint64_t)R);
     }
 }
+
+OUCHI_TEST_CASE(carry_chain_test) {
+    using namespace chao::detail;
+    constexpr auto ce = []() {
+        std::uint64_t a[2] = {~0ull, 1}, b[2] = {1, 0};
+        auto c = impl_base::add_n(a, b, 2);
+        auto d = impl_base::sub_n(a, b, 2);
+        return std::make_tuple(a[0], a[1], c, d);
+    }();
+    OUCHI_REQUIRE_EQUAL(std::get<0>(ce), ~0ull);
+    OUCHI_REQUIRE_EQUAL(std::get<1>(ce), 1ull);
+    OUCHI_REQUIRE_EQUAL(std::get<2>(ce), 0);
+    OUCHI_REQUIRE_EQUAL(std::get<3>(ce), 0);
+
+    std::mt19937_64 r(std::random_device{}());
+    for(auto i = 0u; i < 0xFFFF; ++i) {
+        const std::uint64_t a = r() | (i & 1 ? ~0ull : 0), b = r();
+        const unsigned char c = r() & 1;
+        const unsigned __int128 s = (unsigned __int128)a + b + c;
+        const unsigned __int128 d = (unsigned __int128)a - b - c;
+        std::uint64_t out;
+        OUCHI_REQUIRE_EQUAL((int)impl_base::addc(c, a, b, out), (int)(s >> 64));
+        OUCHI_REQUIRE_EQUAL(out, (std::uint64_t)s);
+        OUCHI_REQUIRE_EQUAL((int)impl_base::subb(c, a, b, out), (int)!!(d >> 64));
+        OUCHI_REQUIRE_EQUAL(out, (std::uint64_t)d);
+    }
+}
+
+OUCHI_TEST_CASE(int_representation_karatsuba_test1024) {
+    using namespace chao::detail;
+    int_representation<1024> a, b, k, n;
+    std::mt19937_64 r(std::random_device{}());
+    for(auto i = 0u; i < 1000; ++i){
+        for(auto j = 0u; j < a.length; ++j) {
+            a.poly[j] = r();
+            b.poly[j] = i & 1 ? r() : ~0ull;
+        }
+        karatsuba::mul(k, a, b);
+        naive_mul::mul(n, a, b);
+        for(auto j = 0u; j < k.length; ++j) {
+            OUCHI_REQUIRE_EQUAL(k.poly[j], n.poly[j]);
+        }
+    }
+}
+
+OUCHI_TEST_CASE(fixed_length_kernel_test256) {
+    using namespace chao::detail;
+    using chao::sign;
+    std::mt19937_64 r(std::random_device{}());
+    for(auto i = 0u; i < 0xFFFF; ++i) {
+        int_representation<256> a, b;
+        for(auto j = 0u; j < a.length; ++j) {
+            a.poly[j] = r();
+            b.poly[j] = i & 1 ? a.poly[j] : r();
+        }
+        if(i & 2) b.poly[0] = r();
+        int_representation<1024> sa, sb, ua, ub;
+        sa.cpy<sign::mp_signed>(a);
+        sb.cpy<sign::mp_signed>(b);
+        ua.cpy<sign::mp_unsigned>(a);
+        ub.cpy<sign::mp_unsigned>(b);
+        OUCHI_REQUIRE_EQUAL((impl_base::cmp<sign::mp_signed>(a, b)), (impl_base::cmp<sign::mp_signed>(sa, sb)));
+        OUCHI_REQUIRE_EQUAL((impl_base::cmp<sign::mp_unsigned>(a, b)), (impl_base::cmp<sign::mp_unsigned>(ua, ub)));
+
+        const auto w = (unsigned int)(r() % 300);
+        auto l = a, rs = a, ru = a;
+        auto L = ua, RS = sa, RU = ua;
+        bitop::shiftl(l, w);
+        bitop::shiftl(L, w);
+        bitop::shiftr<sign::mp_signed>(rs, w);
+        bitop::shiftr<sign::mp_signed>(RS, w);
+        bitop::shiftr<sign::mp_unsigned>(ru, w);
+        bitop::shiftr<sign::mp_unsigned>(RU, w);
+        for(auto j = 0u; j < a.length; ++j) {
+            OUCHI_REQUIRE_EQUAL(l.poly[j], L.poly[j]);
+            OUCHI_REQUIRE_EQUAL(rs.poly[j], RS.poly[j]);
+            OUCHI_REQUIRE_EQUAL(ru.poly[j], RU.poly[j]);
+        }
+    }
+}
+
+OUCHI_TEST_CASE(active_length_test4096) {
+    using namespace chao::detail;
+    using chao::sign;
+    std::mt19937_64 r(std::random_device{}());
+    for(auto i = 0u; i < 200; ++i) {
+        int_representation<4096> a, b, p, P, q, rem, t;
+        a.flush();
+        b.flush();
+        // 宣言された幅よりずっと小さい値
+        const auto la = (unsigned int)(r() % 40) + 1, lb = i % 4 == 0 ? 1u : (unsigned int)(r() % 30) + 1;
+        for(auto j = 0u; j < la; ++j) a.poly[j] = r();
+        for(auto j = 0u; j < lb; ++j) b.poly[j] = r();
+        OUCHI_REQUIRE_EQUAL(impl_base::active_length(a), la - (a.poly[la - 1] == 0));
+        karatsuba::mul(p, a, b);
+        naive_mul::mul(P, a, b);
+        for(auto j = 0u; j < p.length; ++j) OUCHI_REQUIRE_EQUAL(p.poly[j], P.poly[j]);
+
+        // q * b + rem == a, rem < b
+        naive_mul::div<sign::mp_unsigned>(q, rem, a, b);
+        OUCHI_REQUIRE_EQUAL((impl_base::cmp<sign::mp_unsigned>(rem, b)), -1);
+        naive_mul::mul(t, q, b);
+        impl_base::plus(t, rem);
+        for(auto j = 0u; j < a.length; ++j) OUCHI_REQUIRE_EQUAL(t.poly[j], a.poly[j]);
+
+        // 符号付き: 切り捨て除算
+        auto na = a, nb = b;
+        if(i & 1) impl_base::negate(na);
+        if(i & 2) impl_base::negate(nb);
+        int_representation<4096> sq, sr;
+        naive_mul::div<sign::mp_signed>(sq, sr, na, nb);
+        if(i & 1) impl_base::negate(rem);
+        if((i & 1) != ((i >> 1) & 1)) impl_base::negate(q);
+        for(auto j = 0u; j < a.length; ++j) {
+            OUCHI_REQUIRE_EQUAL(sq.poly[j], q.poly[j]);
+            OUCHI_REQUIRE_EQUAL(sr.poly[j], rem.poly[j]);
+        }
+    }
+}